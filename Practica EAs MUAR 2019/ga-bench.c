@@ -0,0 +1,133 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Cost of selection as the pool grows: OneMax on packed bit strings
+|
+| Usage: ga-bench config [config line]...
+|
+|    config      = GA configuration file (e.g. GAconfig_bit)
+|    config line = config lines applied after the file, e.g.
+|                  "selection roulette" or "ga steady_state"
+|
+| Runs the GA with pools of 1000 up to 1000000 chromosomes of 64 bits, each
+| for about the same number of children, and prints the time taken by the
+| initial pool and the time per child after it.  Each pool is run twice:
+| as configured, and with "selection uniform_random" on top, whose spin is
+| a single random number.  The time per child grows with the pool in both
+| runs (parents are picked from all over a pool that no longer fits in the
+| caches); the difference is what the selection costs.  The goal is that
+| this costs the same work per child (O(1)) whatever the pool size; with
+| the roulette or sus it still grows a little once the wheel, too, no
+| longer fits in the caches.  The config lines may change anything but the
+| pool size, the chromosomes and the number of iterations.
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+
+#define CHILDREN 2000000   /* Children of each run (about) */
+#define MIN_POOL 1000      /* Smallest pool */
+#define MAX_POOL 1000000   /* Largest pool */
+
+int    obj_fun();    /*--- Forward declarations ---*/
+double run();
+
+/*--- Evaluations of the current run, and when the pool was done ---*/
+long   num_eval, pool_size;
+double pool_time;
+
+/*----------------------------------------------------------------------------
+| main()
+----------------------------------------------------------------------------*/
+int main(argc, argv)
+   int  argc;
+   char *argv[];
+{
+   double pool, child, uniform, best;
+   int    size;
+
+   /*--- Arguments ---*/
+   if(argc < 2) {
+      fprintf(stderr, "Usage: %s config [config line]...\n", argv[0]);
+      exit(1);
+   }
+
+   printf("   Pool   Children  Pool (s)  Child (ns)  Uniform (ns)  "
+          "Selection (ns)     Best\n");
+   printf("-------  ---------  --------  ----------  ------------  "
+          "--------------  -------\n");
+   for(size = MIN_POOL; size <= MAX_POOL; size *= 10) {
+      child   = run(argc, argv, size, FALSE, &pool, &best);
+      uniform = run(argc, argv, size, TRUE, NULL, NULL);
+      printf("%7d  %9ld  %8.3f  %10.1f  %12.1f  %14.1f  %7G\n", size,
+             num_eval - pool_size, pool, child, uniform, child - uniform, best);
+      fflush(stdout);
+   }
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+| run() - one run with a pool of size chromosomes, selecting uniformly at
+| random if uniform; returns the time per child in ns, and if wanted the
+| time taken by the initial pool (s) and the best fitness
+----------------------------------------------------------------------------*/
+double run(argc, argv, size, uniform, pool, best)
+   int    argc;
+   char   *argv[];
+   int    size, uniform;
+   double *pool, *best;
+{
+   GA_Info_Ptr ga_info;
+   char        line[80];
+   double      start, end;
+   int         i, iter;
+
+   /*--- Configure: the file, the OneMax problem, then the user ---*/
+   ga_info = GA_config(argv[1], obj_fun);
+   CF_line(ga_info, "datatype bit");
+   CF_line(ga_info, "packed_bits true");
+   CF_line(ga_info, "chrom_len 64");
+   CF_line(ga_info, "objective maximize");
+   CF_line(ga_info, "rp_type none");
+   for(i = 2; i < argc; i++) {
+      if(strlen(argv[i]) >= 80) UT_error("ga-bench: config line too long");
+      CF_line(ga_info, argv[i]);
+   }
+   if(uniform) CF_line(ga_info, "selection uniform_random");
+
+   /*--- A generation breeds the pool, a trial a batch ---*/
+   if(!strcmp(GA_name(ga_info), "generational"))
+      iter = CHILDREN / size;
+   else
+      iter = CHILDREN / (ga_info->batch > 2 ? ga_info->batch : 2);
+   if(iter < 1) iter = 1;
+   sprintf(line, "pool_size %d", size);
+   CF_line(ga_info, line);
+   sprintf(line, "stop_after %d ignore_convergence", iter);
+   CF_line(ga_info, line);
+
+   /*--- Run ---*/
+   num_eval  = 0;
+   pool_size = size;
+   start     = EX_clock();
+   GA_run(ga_info);
+   end       = EX_clock();
+   if(num_eval <= pool_size) UT_error("ga-bench: no children");
+
+   if(pool != NULL) *pool = pool_time - start;
+   if(best != NULL) *best = ga_info->best->fitness;
+   CF_free(ga_info);
+   return (end - pool_time) * 1e9 / (num_eval - pool_size);
+}
+
+/*----------------------------------------------------------------------------
+| obj_fun() - number of ones (evaluation threads may call it at once)
+----------------------------------------------------------------------------*/
+int obj_fun(chrom)
+   Chrom_Ptr chrom;
+{
+   chrom->fitness = CH_ones(chrom, 0, chrom->length);
+
+   if(__sync_add_and_fetch(&num_eval, 1) == pool_size)
+      pool_time = EX_clock();
+   return 0;
+}
@@ -0,0 +1,82 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Island model GA on a TSP instance, one process per island (see libga/net.c)
+|
+| Usage: ga-island config instance [config line]...
+|
+|    config      = GA configuration file ("ga islands")
+|    instance    = TSP file, as read by load_map.c (e.g. lin105.tsp.txt)
+|    config line = config lines applied after the file, e.g.
+|                  "net_role coordinator" or "net_role island"
+|
+| Start the coordinator and then the islands (the "islands" directive says
+| how many), all with the same config file and instance:
+|
+|    ga-island GAconfig lin105.tsp.txt "net_role coordinator" &
+|    ga-island GAconfig lin105.tsp.txt "net_role island" &
+|    ...
+|
+| The coordinator prints the reports; with net_role none all islands run
+| in this process, as threads.
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+#include "load_map.c"
+
+int obj_fun();    /*--- Forward declaration ---*/
+
+/*----------------------------------------------------------------------------
+| main()
+----------------------------------------------------------------------------*/
+int main(argc, argv)
+   int  argc;
+   char *argv[];
+{
+   GA_Info_Ptr ga_info;
+   int         i;
+
+   /*--- Arguments ---*/
+   if(argc < 3) {
+      fprintf(stderr, "Usage: %s config instance [config line]...\n", argv[0]);
+      exit(1);
+   }
+
+   /*--- Read instance ---*/
+   if(load_inst(argv[2]) < 0) UT_error("ga-island: error reading instance");
+
+   /*--- Configure; one gene per city ---*/
+   ga_info = GA_config(argv[1], obj_fun);
+   for(i = 3; i < argc; i++) {
+      if(strlen(argv[i]) >= 80) UT_error("ga-island: config line too long");
+      CF_line(ga_info, argv[i]);
+   }
+   ga_info->chrom_len = NN;
+   CF_verify(ga_info);
+
+   /*--- Run ---*/
+   GA_run(ga_info);
+   if(ga_info->net_role != NT_ISLAND)
+      printf("\nThe GA found a tour of length %G\n", ga_info->best->fitness);
+
+   CF_free(ga_info);
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+| obj_fun() - length of the tour (cities are numbered 1..NN)
+----------------------------------------------------------------------------*/
+int obj_fun(Chrom_Ptr chrom)
+{
+  int i;
+  double val = 0.0;
+
+  for(i = 1; i < chrom->length; i++)
+    val += DISTANCES[(int)chrom->gene[i-1] - 1][(int)chrom->gene[i] - 1];
+  val += DISTANCES[(int)chrom->gene[chrom->length-1] - 1]
+                  [(int)chrom->gene[0] - 1];
+
+  chrom->fitness = val;
+
+  return 0;
+}
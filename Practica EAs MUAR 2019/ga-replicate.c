@@ -0,0 +1,80 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Replicate runs of a GA on a TSP instance
+|
+| Usage: ga-replicate config instance runs [threads [csv_file]]
+|
+|    config   = GA configuration file (rand_seed is the seed of run 1,
+|               run 2 uses rand_seed+1, and so on)
+|    instance = TSP file, as read by load_map.c (e.g. kroA100.tsp.txt)
+|    runs     = number of replicate runs
+|    threads  = runs done at the same time (default: all processors)
+|    csv_file = where to write the results (default: stdout)
+============================================================================*/
+#include "ga.h"
+#include "load_map.c"
+
+int obj_fun();    /*--- Forward declaration ---*/
+
+/*----------------------------------------------------------------------------
+| main()
+----------------------------------------------------------------------------*/
+int main(argc, argv)
+   int  argc;
+   char *argv[];
+{
+   GA_Info_Ptr   ga_info;
+   EX_Result_Ptr res;
+   FILE          *fid = stdout;
+   int           runs, threads = 0;
+
+   /*--- Arguments ---*/
+   if(argc < 4 || sscanf(argv[3], "%d", &runs) != 1 || runs <= 0) {
+      fprintf(stderr,
+         "Usage: %s config instance runs [threads [csv_file]]\n", argv[0]);
+      exit(1);
+   }
+   if(argc >= 5) sscanf(argv[4], "%d", &threads);
+   if(argc >= 6 && (fid = fopen(argv[5], "w")) == NULL)
+      UT_error("ga-replicate: error opening csv file");
+
+   /*--- Read instance (shared by all runs, read only) ---*/
+   if(load_inst(argv[2]) < 0) UT_error("ga-replicate: error reading instance");
+
+   /*--- Configure; one gene per city ---*/
+   ga_info = GA_config(argv[1], obj_fun);
+   ga_info->chrom_len = NN;
+   CF_verify(ga_info);
+
+   /*--- Do the runs ---*/
+   res = (EX_Result_Ptr)calloc(runs, sizeof(EX_Result_Type));
+   if(res == NULL) UT_error("ga-replicate: alloc failed");
+   EX_replicate(ga_info, runs, threads, res);
+
+   /*--- Results ---*/
+   EX_csv(fid, res, runs, ga_info->minimize);
+   if(fid != stdout) fclose(fid);
+
+   free(res);
+   CF_free(ga_info);
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+| obj_fun() - length of the tour (cities are numbered 1..NN)
+----------------------------------------------------------------------------*/
+int obj_fun(Chrom_Ptr chrom)
+{
+  int i;
+  double val = 0.0;
+
+  for(i = 1; i < chrom->length; i++)
+    val += DISTANCES[(int)chrom->gene[i-1] - 1][(int)chrom->gene[i] - 1];
+  val += DISTANCES[(int)chrom->gene[chrom->length-1] - 1]
+                  [(int)chrom->gene[0] - 1];
+
+  chrom->fitness = val;
+
+  return 0;
+}
@@ -0,0 +1,244 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Parameter sweep of a GA, with racing (see libga/race.c)
+|
+| Usage: ga-sweep config variants instance... [-b blocks] [-m min_blocks]
+|                 [-a alpha] [-t threads] [-x]
+|
+|    config        = base GA configuration file (rand_seed is the seed of
+|                    block 1, block 2 uses rand_seed+1, and so on)
+|    variants      = what to change in config (see below)
+|    instance      = TSP file(s), as read by load_map.c; block b is run on
+|                    instance b modulo the number of instances
+|    -b blocks     = most runs of a variant (default: 40)
+|    -m min_blocks = blocks before the first test (default: 5)
+|    -a alpha      = significance level of the tests (default: 0.05)
+|    -t threads    = runs done at the same time (default: all processors)
+|    -x            = exhaustive sweep: no variant is dropped
+|
+| Each line of the variants file lists alternatives separated by '|'.  An
+| alternative is one or more config lines separated by ';'; a single word
+| is taken as a new value for the first command of the line:
+|
+|    x_rate 0.6 | 0.8 | 0.95
+|    crossover order1 | crossover pmx; x_rate 1
+|
+| The variants are all combinations of one alternative of each line: many
+| lines make a grid, a single line makes a list.  Lines starting with '#'
+| are skipped.
+|
+| Built with -DCLIQUE (ga-sweep-clq) the instances are graphs, as read by
+| load_graph.c, and the objective is the size of a clique: a bit string
+| chromosome selects vertices, less one for each pair of them that is not
+| an edge (dropping one vertex per missing edge leaves a clique at least
+| that large).  Use "objective maximize".
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+#ifdef CLIQUE
+#include "load_graph.c"
+#define INST_DATA ADJ
+#else
+#include "load_map.c"
+#define INST_DATA DISTANCES
+#endif
+
+#define MAX_LINES 32     /* Lines in the variants file */
+#define MAX_ALTS  64     /* Alternatives on a line */
+#define LINE_LEN  1024   /* Length of a line of the variants file */
+
+int obj_fun();           /*--- Forward declaration ---*/
+int set_inst();
+
+/*--- Instances, all read at the start ---*/
+int  num_inst;
+void **inst_data;
+int  *inst_nn;
+
+/*----------------------------------------------------------------------------
+| main()
+----------------------------------------------------------------------------*/
+int main(argc, argv)
+   int  argc;
+   char *argv[];
+{
+   GA_Info_Ptr   *var;
+   RA_Result_Ptr res;
+   FILE          *fid;
+   char          line[LINE_LEN], cmd[LINE_LEN], str[LINE_LEN], *p, *q;
+   char          *alt[MAX_LINES][MAX_ALTS], **name;
+   int           num_alt[MAX_LINES], num_lines, num_var;
+   int           blocks = 40, min_blocks = 5, threads = 0, exhaustive = FALSE;
+   double        alpha = 0.05;
+   int           i, j, k, v, runs;
+
+   /*--- Arguments ---*/
+   for(i = 3, num_inst = 0; i < argc; i++) {
+      if(argv[i][0] != '-') { num_inst++; continue; }
+      if(!strcmp(argv[i], "-x")) { exhaustive = TRUE; continue; }
+      if(i + 1 >= argc) break;
+      if(!strcmp(argv[i], "-b"))      sscanf(argv[++i], "%d", &blocks);
+      else if(!strcmp(argv[i], "-m")) sscanf(argv[++i], "%d", &min_blocks);
+      else if(!strcmp(argv[i], "-a")) sscanf(argv[++i], "%lf", &alpha);
+      else if(!strcmp(argv[i], "-t")) sscanf(argv[++i], "%d", &threads);
+      else break;
+   }
+   if(i < argc || num_inst == 0 || blocks <= 0) {
+      fprintf(stderr, "Usage: %s config variants instance... [-b blocks] "
+              "[-m min_blocks] [-a alpha] [-t threads] [-x]\n", argv[0]);
+      exit(1);
+   }
+   if(exhaustive) alpha = 0.0;
+
+   /*--- Read instances (shared by all runs, read only) ---*/
+   inst_data = (void **)calloc(num_inst, sizeof(void *));
+   inst_nn   = (int *)calloc(num_inst, sizeof(int));
+   if(inst_data == NULL || inst_nn == NULL) UT_error("ga-sweep: alloc failed");
+   for(i = 3, j = 0; i < argc; i++) {
+      if(argv[i][0] == '-') { if(strcmp(argv[i], "-x")) i++; continue; }
+      if(load_inst(argv[i]) < 0) UT_error("ga-sweep: error reading instance");
+      inst_data[j] = (void *)INST_DATA;
+      inst_nn[j++] = NN;
+   }
+
+   /*--- Read variants: alt[l][a] is alternative a of line l ---*/
+   if((fid = fopen(argv[2], "r")) == NULL)
+      UT_error("ga-sweep: error opening variants file");
+   for(num_lines = 0; fgets(line, LINE_LEN, fid) != NULL; ) {
+      if((p = strchr(line, '\n')) != NULL) *p = 0;
+      for(p = line; *p == ' ' || *p == '\t'; p++)
+         ;
+      if(*p == 0 || *p == '#') continue;
+      if(num_lines >= MAX_LINES) UT_error("ga-sweep: too many variant lines");
+      num_alt[num_lines] = 0;
+      cmd[0] = 0;
+      for(; p != NULL; p = q) {
+         if((q = strchr(p, '|')) != NULL) *q++ = 0;
+         if(num_alt[num_lines] >= MAX_ALTS)
+            UT_error("ga-sweep: too many alternatives");
+
+         /*--- Trim; a single word is a value for the first command ---*/
+         while(*p == ' ' || *p == '\t') p++;
+         for(k = strlen(p); k > 0 && (p[k-1] == ' ' || p[k-1] == '\t'); k--)
+            p[k-1] = 0;
+         if(cmd[0] == 0) sscanf(p, "%s", cmd);
+         else if(strchr(p, ' ') == NULL && strchr(p, ';') == NULL) {
+            sprintf(str, "%s %s", cmd, p);
+            p = str;
+         }
+         alt[num_lines][num_alt[num_lines]] = (char *)malloc(strlen(p) + 1);
+         strcpy(alt[num_lines][num_alt[num_lines]++], p);
+      }
+      num_lines++;
+   }
+   fclose(fid);
+
+   /*--- Variants: base config plus one alternative of each line ---*/
+   for(i = 0, num_var = 1; i < num_lines; i++) num_var *= num_alt[i];
+   var  = (GA_Info_Ptr *)calloc(num_var + 1, sizeof(GA_Info_Ptr));
+   name = (char **)calloc(num_var, sizeof(char *));
+   res  = (RA_Result_Ptr)calloc(num_var, sizeof(RA_Result_Type));
+   if(var == NULL || name == NULL || res == NULL)
+      UT_error("ga-sweep: alloc failed");
+   for(v = 0; v < num_var; v++) {
+      var[v]  = GA_config(argv[1], obj_fun);
+      name[v] = (char *)calloc(1, 1);
+      for(i = num_lines - 1, k = v; i >= 0; k /= num_alt[i--]) {
+         p = alt[i][k % num_alt[i]];
+
+         /*--- Name: alternatives joined by "; " ---*/
+         q = (char *)malloc(strlen(name[v]) + strlen(p) + 3);
+         sprintf(q, "%s%s%s", p, name[v][0] ? "; " : "", name[v]);
+         free(name[v]);
+         name[v] = q;
+
+         /*--- Apply its config lines ---*/
+         strcpy(str, p);
+         for(p = str; p != NULL; p = q) {
+            if((q = strchr(p, ';')) != NULL) *q++ = 0;
+            if(strlen(p) >= 80) UT_error("ga-sweep: config line too long");
+            CF_line(var[v], p);
+         }
+      }
+   }
+   set_inst((void *)var, 0);
+   for(v = 0; v < num_var; v++) CF_verify(var[v]);
+
+   /*--- Race ---*/
+   runs = RA_race(var, num_var, blocks, min_blocks, alpha, threads,
+                  num_inst > 1 ? set_inst : NULL, (void *)var, res);
+   RA_report(stdout, res, name, num_var, blocks, runs, var[0]->minimize);
+
+   for(v = 0; v < num_var; v++) {
+      CF_free(var[v]);
+      free(name[v]);
+   }
+   for(i = 0; i < num_lines; i++)
+      for(j = 0; j < num_alt[i]; j++) free(alt[i][j]);
+   free(var);
+   free(name);
+   free(res);
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+| set_inst() - make instance b (modulo num_inst) the current one for block b
+|              of the race (arg is the array of variants, all of them)
+----------------------------------------------------------------------------*/
+int set_inst(arg, b)
+   void *arg;
+   int  b;
+{
+   GA_Info_Ptr *var;
+   int         i, v;
+
+   var = (GA_Info_Ptr *)arg;
+   i   = b % num_inst;
+
+   INST_DATA = inst_data[i];
+   NN        = inst_nn[i];
+   for(v = 0; var[v] != NULL; v++)
+      var[v]->chrom_len = NN;
+
+   return 0;
+}
+
+#ifdef CLIQUE
+/*----------------------------------------------------------------------------
+| obj_fun() - number of vertices selected, less one for each missing edge
+----------------------------------------------------------------------------*/
+int obj_fun(Chrom_Ptr chrom)
+{
+  int i, j, size = 0, missing = 0;
+
+  for(i = 0; i < chrom->length; i++) {
+    if(chrom->gene[i] < 0.5) continue;
+    size++;
+    for(j = 0; j < i; j++)
+      if(chrom->gene[j] >= 0.5 && !ADJ[i][j]) missing++;
+  }
+
+  chrom->fitness = size - missing;
+
+  return 0;
+}
+#else
+/*----------------------------------------------------------------------------
+| obj_fun() - length of the tour (cities are numbered 1..NN)
+----------------------------------------------------------------------------*/
+int obj_fun(Chrom_Ptr chrom)
+{
+  int i;
+  double val = 0.0;
+
+  for(i = 1; i < chrom->length; i++)
+    val += DISTANCES[(int)chrom->gene[i-1] - 1][(int)chrom->gene[i] - 1];
+  val += DISTANCES[(int)chrom->gene[chrom->length-1] - 1]
+                  [(int)chrom->gene[0] - 1];
+
+  chrom->fitness = val;
+
+  return 0;
+}
+#endif
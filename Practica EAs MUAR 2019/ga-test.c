@@ -2,21 +2,34 @@
 | (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
 |
 | Genetic Algorithm Test Program 
+|
+| Usage: ga-test [config [config line]...]
+|
+|    config      = GA configuration file (default: GAconfig_ejemplo)
+|    config line = config lines applied after the file, e.g.
+|                  "eval_threads 4" (see det-test in the makefile)
 ============================================================================*/
 #include "ga.h"
+#include <string.h>
 
 int obj_fun();    /*--- Forward declaration ---*/
 
 /*----------------------------------------------------------------------------
 | main()
 ----------------------------------------------------------------------------*/
-main() 
+main(argc, argv) 
+   int  argc;
+   char *argv[];
 {
    GA_Info_Ptr ga_info;
    int i;
 
    /*--- Initialize the genetic algorithm ---*/
-   ga_info = GA_config("GAconfig_ejemplo", obj_fun);
+   ga_info = GA_config(argc > 1 ? argv[1] : "GAconfig_ejemplo", obj_fun);
+   for(i = 2; i < argc; i++) {
+      if(strlen(argv[i]) >= 80) UT_error("ga-test: config line too long");
+      CF_line(ga_info, argv[i]);
+   }
 
    /*--- Run the GA ---*/
    GA_run(ga_info);
@@ -27,6 +40,7 @@ main()
    
    printf("   (fitness: %g)\n\n",ga_info->best->fitness);
 
+   return 0;
 }
 
 /*----------------------------------------------------------------------------
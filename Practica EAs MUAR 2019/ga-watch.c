@@ -0,0 +1,78 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Watch the pool of a running GA from another process (see libga/shm.c)
+|
+| Usage: ga-watch name [seconds]
+|
+|    name    = shm_name of the GA (e.g. /ga_pool)
+|    seconds = time between looks (default: 1)
+|
+| Waits for the GA to start, then prints the statistics of its pool each
+| time it has changed, and the best chromosome of the last pool seen when
+| the GA is done.  The GA is never stopped or slowed down.
+============================================================================*/
+#include "ga.h"
+#include <unistd.h>
+
+#define WAIT 30   /* Seconds to wait for the GA to start */
+
+/*----------------------------------------------------------------------------
+| main()
+----------------------------------------------------------------------------*/
+int main(argc, argv)
+   int  argc;
+   char *argv[];
+{
+   SM_Ptr    sm;
+   Pool_Ptr  pool;
+   Chrom_Ptr best;
+   double    seconds = 1.0;
+   int       i, t, iter, last = -2, live;
+
+   /*--- Arguments ---*/
+   if(argc < 2 || (argc >= 3 && sscanf(argv[2], "%lf", &seconds) != 1) ||
+      seconds <= 0.0) {
+      fprintf(stderr, "Usage: %s name [seconds]\n", argv[0]);
+      exit(1);
+   }
+
+   /*--- Wait for the GA ---*/
+   for(t = 0; (sm = SM_attach(argv[1])) == NULL; t++) {
+      if(t >= WAIT * 10) UT_error("ga-watch: no GA with that shm_name");
+      usleep(100000);
+   }
+
+   /*--- Look until it is done ---*/
+   pool = PL_alloc(1);
+   printf("Iter     Size    Min      Max      Ave     Std Dev    Best\n");
+   printf("------  -----  -------  -------  -------  --------  -------\n");
+   do {
+      live = SM_live(sm);
+      if((iter = SM_read(sm, pool)) == ERROR) break;
+      if(iter != last && pool->size > 0) {
+         printf("%6d  %5d  %7G  %7G  %7G  %8.3G  %7G\n", iter + 1, pool->size,
+                pool->min, pool->max, pool->ave, pool->dev,
+                pool->best_index >= 0 ? pool->chrom[pool->best_index]->fitness
+                                      : 0.0);
+         fflush(stdout);
+         last = iter;
+      }
+      if(live) usleep((useconds_t)(seconds * 1e6));
+   } while(live);
+
+   /*--- Best of the last pool seen ---*/
+   if(pool->size > 0 && pool->best_index >= 0) {
+      best = pool->chrom[pool->best_index];
+      printf("\nBest: ");
+      for(i = 0; i < best->length; i++) {
+         printf("%G ", best->gene[i]);
+         if(i % 20 == 19 && i+1 < best->length) printf("\n      ");
+      }
+      printf(" (%g)\n", best->fitness);
+   }
+
+   PL_free(pool);
+   SM_free(sm);
+   return 0;
+}
@@ -0,0 +1,353 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Asynchronous steady state GA
+|
+| Operators
+|    GA_ss_async()   - asynchronous steady state GA ("ga async_steady_state")
+|       AS_item()    - helper for GA_ss_async() (master or worker)
+|       AS_master()  - breed children and put them into the pool
+|       AS_worker()  - evaluate children
+|
+| Utility
+|    AS_breed()      - select, cross and mutate a pair of children
+|    AS_put()        - add a job to a queue
+|    AS_get()        - take a job from a queue
+|    AS_wait()       - take a given job from a queue
+|
+| NOTE: There are eval_threads workers.  Each of them always has a pair of
+|       children to evaluate: as soon as a pair is done the master puts it
+|       into the pool with RE_fun() and breeds the next one.  Only the
+|       master touches the pool, but the evaluation function is called
+|       from several threads at once and MUST be thread safe.  Since the
+|       order in which pairs are finished depends on the threads, runs are
+|       only reproducible with a single worker.  With eval_procs > 0 there
+|       are eval_procs workers instead, each of them evaluating on a process
+|       of its own (see proc.c).
+|
+|       With "deterministic true" there are always AS_WINDOW pairs out, no
+|       matter how many workers, and the master takes them back in the
+|       order it bred them: the oldest pair is waited for even if others
+|       are done.  Runs are then the same with any number of workers.
+============================================================================*/
+#include "ga.h"
+
+#define AS_WINDOW 16   /* Pairs out at a time if deterministic */
+
+/*--- A pair of children (and copies of their parents) ---*/
+typedef struct {
+   Chrom_Ptr p1, p2;      /* Parents, as they were when selected */
+   Chrom_Ptr c1, c2;      /* Children */
+} AS_Job_Type, *AS_Job_Ptr;
+
+/*--- A queue of job numbers ---*/
+typedef struct {
+   int *job;              /* Job numbers (circular) */
+   int head, num;         /* First job, number of jobs */
+} AS_Queue_Type, *AS_Queue_Ptr;
+
+/*--- Everything shared by master and workers ---*/
+typedef struct {
+   GA_Info_Ptr     ga_info;
+   AS_Job_Ptr      job;               /* The jobs */
+   int             num_jobs;          /* Number of jobs */
+   int             num_workers;       /* Number of workers */
+   AS_Queue_Type   todo, done;        /* To be evaluated / evaluated */
+   pthread_mutex_t lock;              /* Protects queues and quit */
+   pthread_cond_t  todo_cv, done_cv;  /* Queue is no longer empty */
+   int             quit;              /* Workers should exit */
+} AS_Type, *AS_Ptr;
+
+void AS_item();
+
+/*============================================================================
+|                       Asynchronous Steady State GA
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Asynchronous steady-state GA
+----------------------------------------------------------------------------*/
+GA_ss_async(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   AS_Type     as;
+   TH_Pool_Ptr tp;
+   int         i;
+
+   /*--- Initialize (same as steady state) ---*/
+   GA_ss_init(ga_info);
+
+   /*--- One job per worker (or a fixed number of them) ---*/
+   as.ga_info     = ga_info;
+   as.num_workers = ga_info->eval_threads;
+   if(PR_valid(ga_info->pr_pool)) as.num_workers = ga_info->pr_pool->num_procs;
+   as.num_jobs    = ga_info->deterministic ? AS_WINDOW : as.num_workers;
+   as.job      = (AS_Job_Ptr)calloc(as.num_jobs, sizeof(AS_Job_Type));
+   as.todo.job = (int *)calloc(as.num_jobs, sizeof(int));
+   as.done.job = (int *)calloc(as.num_jobs, sizeof(int));
+   if(as.job == NULL || as.todo.job == NULL || as.done.job == NULL)
+      UT_error("GA_ss_async: alloc failed");
+   for(i = 0; i < as.num_jobs; i++) {
+      as.job[i].p1 = CH_alloc(ga_info->chrom_len);
+      as.job[i].p2 = CH_alloc(ga_info->chrom_len);
+      as.job[i].c1 = CH_alloc(ga_info->chrom_len);
+      as.job[i].c2 = CH_alloc(ga_info->chrom_len);
+   }
+   as.todo.head = as.todo.num = 0;
+   as.done.head = as.done.num = 0;
+   as.quit      = FALSE;
+   pthread_mutex_init(&as.lock, NULL);
+   pthread_cond_init(&as.todo_cv, NULL);
+   pthread_cond_init(&as.done_cv, NULL);
+
+   /*--- Master (item 0) and workers, one thread each ---*/
+   tp = TH_alloc(as.num_workers + 1);
+   TH_run(tp, AS_item, (void *)&as, as.num_workers + 1);
+   TH_free(tp);
+
+   /*--- Final report ---*/
+   RP_final(ga_info);
+
+   /*--- Clean up ---*/
+   pthread_mutex_destroy(&as.lock);
+   pthread_cond_destroy(&as.todo_cv);
+   pthread_cond_destroy(&as.done_cv);
+   for(i = 0; i < as.num_jobs; i++) {
+      CH_free(as.job[i].p1);
+      CH_free(as.job[i].p2);
+      CH_free(as.job[i].c1);
+      CH_free(as.job[i].c2);
+   }
+   free(as.job);
+   free(as.todo.job);
+   free(as.done.job);
+   GA_done(ga_info);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Item 0 is the master, all others are workers
+|
+| TH_run() is called with one item per thread, so each of them gets a
+| thread of its own for as long as it runs.
+----------------------------------------------------------------------------*/
+void AS_item(arg, i, id)
+   void *arg;
+   int  i, id;
+{
+   if(i == 0) AS_master((AS_Ptr)arg);
+   else       AS_worker((AS_Ptr)arg, i - 1);
+}
+
+/*----------------------------------------------------------------------------
+| Master: one trial for each pair of children that comes back
+----------------------------------------------------------------------------*/
+AS_master(as)
+   AS_Ptr as;
+{
+   GA_Info_Ptr ga_info;
+   AS_Job_Ptr  job;
+   int         j;
+
+   ga_info = as->ga_info;
+
+   /*--- Give every worker something to do ---*/
+   for(j = 0; j < as->num_jobs; j++) {
+      AS_breed(ga_info, &as->job[j]);
+      AS_put(as, &as->todo, &as->todo_cv, j);
+   }
+
+   /*--- Outer loop is for each trial ---*/
+   for(ga_info->iter = 0;
+       ga_info->max_iter < 0 || ga_info->iter < ga_info->max_iter;
+       ga_info->iter++) {
+
+      /*--- Check convergence (only if no mutation) ---*/
+      if(ga_info->use_convergence && ga_info->converged) break;
+
+      /*--- Wait for any pair of children (the oldest if deterministic) ---*/
+      if(ga_info->deterministic)
+         j = AS_wait(as, &as->done, &as->done_cv,
+                     ga_info->iter % as->num_jobs);
+      else
+         j = AS_get(as, &as->done, &as->done_cv);
+      job = &as->job[j];
+
+      /*--- Validate children ---*/
+      CH_verify(ga_info, job->c1);
+      CH_verify(ga_info, job->c2);
+
+      /*--- Replacement ---*/
+      RE_fun(ga_info, ga_info->new_pool, job->p1, job->p2, job->c1, job->c2);
+
+      /*--- Best So Far? ---*/
+      GA_cum(ga_info, job->c1, job->c2);
+
+      /*--- Update GA system statistics (two slots changed at most) ---*/
+      PL_restat(ga_info, ga_info->new_pool);
+
+      /*--- Print report if appropriate ---*/
+      RP_report(ga_info, ga_info->new_pool);
+
+      /*--- Pool monitor in shared memory ---*/
+      SM_sync(ga_info, ga_info->new_pool);
+
+      /*--- Next pair, unless this was the last trial ---*/
+      if(ga_info->max_iter >= 0 && ga_info->iter + 1 >= ga_info->max_iter)
+         continue;
+      AS_breed(ga_info, job);
+      AS_put(as, &as->todo, &as->todo_cv, j);
+   }
+
+   /*--- Tell workers to quit ---*/
+   pthread_mutex_lock(&as->lock);
+   as->quit = TRUE;
+   pthread_cond_broadcast(&as->todo_cv);
+   pthread_mutex_unlock(&as->lock);
+}
+
+/*----------------------------------------------------------------------------
+| Worker w: evaluate pairs of children until told to quit
+----------------------------------------------------------------------------*/
+AS_worker(as, w)
+   AS_Ptr as;
+   int    w;
+{
+   AS_Job_Ptr job;
+   Chrom_Ptr  pair[2];
+   int        j;
+
+   pthread_mutex_lock(&as->lock);
+   while(TRUE) {
+
+      /*--- Wait for a pair ---*/
+      while(!as->quit && as->todo.num == 0)
+         pthread_cond_wait(&as->todo_cv, &as->lock);
+      if(as->quit) break;
+      j = as->todo.job[as->todo.head];
+      as->todo.head = (as->todo.head + 1) % as->num_jobs;
+      as->todo.num--;
+      pthread_mutex_unlock(&as->lock);
+
+      /*--- Evaluate it ---*/
+      job = &as->job[j];
+      if(PR_valid(as->ga_info->pr_pool)) {
+         pair[0] = job->c1;
+         pair[1] = job->c2;
+         PR_eval_on(as->ga_info->pr_pool, w, pair, 2);
+      } else {
+         as->ga_info->EV_fun(job->c1);
+         as->ga_info->EV_fun(job->c2);
+      }
+
+      /*--- Hand it back ---*/
+      pthread_mutex_lock(&as->lock);
+      as->done.job[(as->done.head + as->done.num) % as->num_jobs] = j;
+      as->done.num++;
+      pthread_cond_signal(&as->done_cv);
+   }
+   pthread_mutex_unlock(&as->lock);
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Breed a pair of children (as in GA_trial())
+----------------------------------------------------------------------------*/
+AS_breed(ga_info, job)
+   GA_Info_Ptr ga_info;
+   AS_Job_Ptr  job;
+{
+   Chrom_Ptr parent1, parent2;
+
+   /*--- Selection (the pool stays put for both parents) ---*/
+   SE_prepare(ga_info, ga_info->old_pool);
+   ga_info->se_ready = TRUE;
+   parent1 = SE_fun(ga_info, ga_info->old_pool);
+   parent2 = SE_fun(ga_info, ga_info->old_pool);
+   ga_info->se_ready = FALSE;
+
+   /*--- Validate parents ---*/
+   CH_verify(ga_info, parent1);
+   CH_verify(ga_info, parent2);
+
+   /*--- Parents may be replaced before the children are back ---*/
+   CH_copy(parent1, job->p1);
+   CH_copy(parent2, job->p2);
+
+   /*--- Crossover ---*/
+   X_fun(ga_info, parent1, parent2, job->c1, job->c2);
+
+   /*--- Mutation ---*/
+   MU_fun(ga_info, job->c1);
+   MU_fun(ga_info, job->c2);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Add job j to queue q and wake up one thread waiting on cv
+----------------------------------------------------------------------------*/
+AS_put(as, q, cv, j)
+   AS_Ptr         as;
+   AS_Queue_Ptr   q;
+   pthread_cond_t *cv;
+   int            j;
+{
+   pthread_mutex_lock(&as->lock);
+   q->job[(q->head + q->num) % as->num_jobs] = j;
+   q->num++;
+   pthread_cond_signal(cv);
+   pthread_mutex_unlock(&as->lock);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Take the first job of queue q, waiting on cv while it is empty
+----------------------------------------------------------------------------*/
+AS_get(as, q, cv)
+   AS_Ptr         as;
+   AS_Queue_Ptr   q;
+   pthread_cond_t *cv;
+{
+   int j;
+
+   pthread_mutex_lock(&as->lock);
+   while(q->num == 0)
+      pthread_cond_wait(cv, &as->lock);
+   j = q->job[q->head];
+   q->head = (q->head + 1) % as->num_jobs;
+   q->num--;
+   pthread_mutex_unlock(&as->lock);
+
+   return j;
+}
+
+/*----------------------------------------------------------------------------
+| Take job j from queue q, waiting on cv until it is there (the last job
+| of the queue takes its place)
+----------------------------------------------------------------------------*/
+AS_wait(as, q, cv, j)
+   AS_Ptr         as;
+   AS_Queue_Ptr   q;
+   pthread_cond_t *cv;
+   int            j;
+{
+   int k, n;
+
+   pthread_mutex_lock(&as->lock);
+   while(TRUE) {
+      for(k = 0; k < q->num && q->job[(q->head + k) % as->num_jobs] != j; k++)
+         ;
+      if(k < q->num) break;
+      pthread_cond_wait(cv, &as->lock);
+   }
+   n = q->num - 1;
+   q->job[(q->head + k) % as->num_jobs] = q->job[(q->head + n) % as->num_jobs];
+   q->num--;
+   pthread_mutex_unlock(&as->lock);
+
+   return j;
+}
@@ -0,0 +1,205 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Parallel reproduction (generational GA with "parallel_repro true")
+|
+| Functions:
+|    BR_generation() - breed all remaining children of a generation
+|    BR_item()       - helper for BR_generation() (one block of pairs)
+|    BR_free()       - free the breeders
+|
+| NOTE: The children are bred in blocks of BR_PAIRS pairs.  Each block has
+|       a breeder: a copy of ga_info (see CF_clone()) with a random number
+|       stream, child buffers and crossover work space of its own.  Blocks
+|       run on the evaluation threads and write their children straight
+|       into their slice of the new pool (replacement append), so crossover,
+|       mutation and evaluation are all done in parallel.  The parents are
+|       all selected beforehand by SE_batch(), with the stream of ga_info,
+|       and the old pool is only read while the blocks run.  Results do not
+|       depend on the number of threads, but differ from those without
+|       parallel_repro.
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+
+#define BR_PAIRS 8   /* Pairs of children per block */
+
+/*--- What each block needs ---*/
+typedef struct {
+   GA_Info_Ptr ga_info;
+   Chrom_Ptr   *kid;      /* Children, by pair */
+   Chrom_Ptr   *mate;     /* Parents, by pair */
+   int         num;       /* Number of children */
+   int         evaluate;  /* Evaluate in block? */
+   int         append;    /* Replacement is append? */
+} BR_Job_Type, *BR_Job_Ptr;
+
+void BR_item();
+
+/*----------------------------------------------------------------------------
+| All remaining trials of a generation (Generational GA only)
+|
+| Same as GA_batch(), but with children bred in parallel.
+----------------------------------------------------------------------------*/
+BR_generation(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   Pool_Ptr    new_pool;
+   BR_Job_Type job;
+   RN_Type     rn;
+   int         i, num, first, num_blocks;
+
+   /*--- Number of children still needed (whole pairs) ---*/
+   new_pool = ga_info->new_pool;
+   num = ga_info->old_pool->size - new_pool->size;
+   if(num <= 0) return OK;
+   num += num % 2;
+   first = new_pool->size;
+
+   /*--- Where do the children go? ---*/
+   job.ga_info  = ga_info;
+   job.num      = num;
+   job.mate     = ga_info->mates;
+   job.append   = !strcmp(RE_name(ga_info), "append");
+   job.evaluate = !PR_valid(ga_info->pr_pool);
+   if(job.append) {
+      if(first + num > new_pool->max_size) PL_resize(new_pool, first + num);
+      job.kid = new_pool->chrom + first;
+   } else {
+      if(num > ga_info->kids->max_size) UT_error("BR_generation: too many kids");
+      job.kid = ga_info->kids->chrom;
+   }
+   for(i = 0; i < num; i++)
+      if(!CH_valid(job.kid[i]))
+         job.kid[i] = PL_new_chrom(job.append ? new_pool : ga_info->kids,
+                                   ga_info->chrom_len);
+
+   /*--- One breeder per block, each with a stream of its own ---*/
+   num_blocks = (num / 2 + BR_PAIRS - 1) / BR_PAIRS;
+   if(num_blocks > ga_info->num_breeders) {
+      ga_info->breeder = (GA_Info_Ptr *)realloc(ga_info->breeder,
+                                         num_blocks * sizeof(GA_Info_Ptr));
+      if(ga_info->breeder == NULL) UT_error("BR_generation: alloc failed");
+      rn = ga_info->rn;
+      for(i = 0; i < num_blocks; i++) {
+         RN_jump(&rn);
+         if(i < ga_info->num_breeders) continue;
+         ga_info->breeder[i] = CF_clone(ga_info);
+         ga_info->breeder[i]->rp_type = RP_NONE;
+         ga_info->breeder[i]->rn      = rn;
+      }
+      ga_info->num_breeders = num_blocks;
+   }
+
+   /*--- Parents of every pair ---*/
+   SE_batch(ga_info, ga_info->old_pool, job.mate, num);
+   for(i = 0; i < num_blocks; i++) {
+      ga_info->breeder[i]->old_pool = ga_info->old_pool;
+      ga_info->breeder[i]->num_mut  = 0;
+   }
+
+   /*--- Breed (and evaluate) every block ---*/
+   if(TH_valid(ga_info->th_pool) && num_blocks > 1) {
+      TH_run(ga_info->th_pool, BR_item, (void *)&job, num_blocks);
+   } else {
+      for(i = 0; i < num_blocks; i++)
+         BR_item((void *)&job, i, 0);
+   }
+
+   /*--- Mutation statistics ---*/
+   for(i = 0; i < num_blocks; i++) {
+      ga_info->num_mut += ga_info->breeder[i]->num_mut;
+      ga_info->tot_mut += ga_info->breeder[i]->num_mut;
+   }
+
+   /*--- Evaluate on processes, then keep the best (as in RE_fun()) ---*/
+   if(!job.evaluate) {
+      EV_batch(ga_info, job.kid, num);
+      if(job.append && ga_info->elitist)
+         for(i = 0; i < num; i += 2)
+            RE_pick_best(ga_info, job.mate[i], job.mate[i+1],
+                         job.kid[i], job.kid[i+1]);
+   }
+
+   /*--- Replacement, in breeding order ---*/
+   for(i = 0; i < num; i += 2) {
+
+      /*--- Validate children ---*/
+      CH_verify(ga_info, job.kid[i]);
+      CH_verify(ga_info, job.kid[i+1]);
+
+      /*--- Replacement (append: already in place, but for pool->fit) ---*/
+      if(!job.append) {
+         RE_fun(ga_info, new_pool, job.mate[i], job.mate[i+1],
+                job.kid[i], job.kid[i+1]);
+      } else {
+         PL_FIT(new_pool, first + i);
+         PL_FIT(new_pool, first + i + 1);
+      }
+
+      /*--- Best So Far? ---*/
+      GA_cum(ga_info, job.kid[i], job.kid[i+1]);
+   }
+   if(job.append) new_pool->size = first + num;
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Breed block b with its breeder
+----------------------------------------------------------------------------*/
+void BR_item(arg, b, id)
+   void *arg;
+   int  b, id;
+{
+   BR_Job_Ptr  job;
+   GA_Info_Ptr br;
+   Chrom_Ptr   *kid, *mate;
+   int         i, last;
+
+   job  = (BR_Job_Ptr)arg;
+   br   = job->ga_info->breeder[b];
+   kid  = job->kid;
+   mate = job->mate;
+   last = MIN(job->num, (b + 1) * 2 * BR_PAIRS);
+
+   for(i = b * 2 * BR_PAIRS; i < last; i += 2) {
+
+      /*--- Validate parents ---*/
+      CH_verify(br, mate[i]);
+      CH_verify(br, mate[i+1]);
+
+      /*--- Crossover ---*/
+      X_fun(br, mate[i], mate[i+1], kid[i], kid[i+1]);
+
+      /*--- Mutation ---*/
+      MU_fun(br, kid[i]);
+      MU_fun(br, kid[i+1]);
+
+      /*--- Evaluation and elitism (else done by caller) ---*/
+      if(!job->evaluate) continue;
+      br->EV_fun(kid[i]);
+      br->EV_fun(kid[i+1]);
+      if(job->append && br->elitist)
+         RE_pick_best(br, mate[i], mate[i+1], kid[i], kid[i+1]);
+   }
+}
+
+/*----------------------------------------------------------------------------
+| Free the breeders of ga_info
+----------------------------------------------------------------------------*/
+BR_free(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   int i;
+
+   for(i = 0; i < ga_info->num_breeders; i++) {
+      ga_info->breeder[i]->old_pool = NULL;
+      CF_free(ga_info->breeder[i]);
+   }
+   if(ga_info->breeder != NULL) free(ga_info->breeder);
+   ga_info->breeder      = NULL;
+   ga_info->num_breeders = 0;
+
+   return OK;
+}
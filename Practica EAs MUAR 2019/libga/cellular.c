@@ -0,0 +1,314 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Cellular (diffusion) GA
+|
+| Operators
+|    GA_cellular()  - cellular GA ("ga cellular")
+|       CE_step()   - one generation (sweep of the grid)
+|       CE_item()   - helper for CE_step() (one stripe)
+|
+| Utility
+|    CE_breed()     - breed a child for one cell
+|    CE_neighbor()  - a neighbor of a cell
+|    CE_run()       - run CE_item() on some stripes, in parallel if possible
+|    CE_width()     - width of a grid
+|
+| NOTE: The pool is a grid_width x (pool_size / grid_width) torus, cell
+|       (r, c) being chromosome r * grid_width + c.  A cell mates with the
+|       better of two random neighbors (von Neumann: 4, Moore: 8) and is
+|       replaced by the child unless the child is worse, so selection and
+|       replacement are not configurable.
+|
+|       The grid is split into stripes of 2 or 3 rows, each with a copy of
+|       ga_info (see CF_clone()) and a random number stream of its own.
+|       With "cell_update synchronous" every cell is bred from the old grid,
+|       then all children are evaluated with EV_batch() and put in at once.
+|       With "cell_update line_sweep" the cells of a stripe are updated one
+|       after the other, so a child may mate in the same generation.  Even
+|       stripes are done first, then odd ones (neighbors are never swept at
+|       the same time).  Either way stripes run on the evaluation threads
+|       and the result does not depend on how many there are.
+============================================================================*/
+#include "ga.h"
+
+/*--- Neighbors: von Neumann (first 4) and Moore (all 8) ---*/
+static int CE_dr[] = { -1, 1,  0, 0, -1, -1,  1, 1 };
+static int CE_dc[] = {  0, 0, -1, 1, -1,  1, -1, 1 };
+
+/*--- The grid and everything shared by the stripes ---*/
+typedef struct {
+   GA_Info_Ptr ga_info;       /* The GA */
+   Pool_Ptr    grid;          /* Cells (ga_info->old_pool) */
+   int         width, height; /* Size of grid */
+   int         num_nb;        /* Number of neighbors (4 or 8) */
+   int         num_stripes;   /* Number of stripes */
+   GA_Info_Ptr *stripe;       /* ga_info of each stripe */
+   int         *todo;         /* Stripes to be done by CE_run() */
+} CE_Type, *CE_Ptr;
+
+void CE_item();
+
+/*============================================================================
+|                                 Cellular GA
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Cellular GA
+----------------------------------------------------------------------------*/
+GA_cellular(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   CE_Type     ce;
+   GA_Info_Ptr cl;
+   RN_Type     rn;
+   int         i;
+
+   /*--- Initialize (a single pool, as for steady state) ---*/
+   GA_ss_init(ga_info);
+
+   /*--- Size of grid ---*/
+   ce.ga_info = ga_info;
+   ce.grid    = ga_info->old_pool;
+   ce.width   = CE_width(ga_info->grid_width, ce.grid->size);
+   if(ce.width > ce.grid->size || ce.grid->size % ce.width != 0)
+      UT_error("GA_cellular: pool size is not a multiple of grid width");
+   ce.height = ce.grid->size / ce.width;
+   ce.num_nb = (ga_info->cell_nbhd == CE_MOORE) ? 8 : 4;
+
+   /*--- Stripes, each with a stream of its own ---*/
+   ce.num_stripes = MAX(1, ce.height / 2);
+   ce.stripe = (GA_Info_Ptr *)calloc(ce.num_stripes, sizeof(GA_Info_Ptr));
+   ce.todo   = (int *)calloc(ce.num_stripes, sizeof(int));
+   if(ce.stripe == NULL || ce.todo == NULL)
+      UT_error("GA_cellular: alloc failed");
+   rn = ga_info->rn;
+   for(i = 0; i < ce.num_stripes; i++) {
+      cl = ce.stripe[i] = CF_clone(ga_info);
+      cl->rp_type = RP_NONE;
+      cl->child1  = CH_alloc(ga_info->chrom_len);
+      cl->child2  = CH_alloc(ga_info->chrom_len);
+      RN_jump(&rn);
+      cl->rn = rn;
+   }
+
+   /*--- Room for all children (synchronous update) ---*/
+   if(ga_info->cell_sweep == CE_SYNC) {
+      ga_info->kids = PL_alloc(ce.grid->size);
+      PL_arena(ga_info->kids, ga_info->chrom_len, CH_store(ga_info));
+      ga_info->kids->size = ce.grid->size;
+   }
+
+   /*--- Outer loop is for each generation ---*/
+   for(ga_info->iter = 0;
+       ga_info->max_iter < 0 || ga_info->iter < ga_info->max_iter;
+       ga_info->iter++) {
+
+      /*--- Check for convergence ---*/
+      if(ga_info->use_convergence && ga_info->converged) break;
+
+      /*--- One generation ---*/
+      CE_step(&ce);
+
+      /*--- Update GA system statistics ---*/
+      PL_stats(ga_info, ce.grid);
+
+      /*--- Best So Far? ---*/
+      GA_cum(ga_info, ce.grid->chrom[ce.grid->best_index],
+                      ce.grid->chrom[ce.grid->best_index]);
+
+      /*--- Print report if appropriate ---*/
+      RP_report(ga_info, ce.grid);
+
+      /*--- Pool monitor in shared memory ---*/
+      SM_sync(ga_info, ce.grid);
+   }
+
+   /*--- Final report ---*/
+   RP_final(ga_info);
+
+   /*--- Clean up ---*/
+   for(i = 0; i < ce.num_stripes; i++) {
+      GA_done(ce.stripe[i]);
+      CF_free(ce.stripe[i]);
+   }
+   free(ce.stripe);
+   free(ce.todo);
+   GA_done(ga_info);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| One generation
+----------------------------------------------------------------------------*/
+CE_step(ce)
+   CE_Ptr ce;
+{
+   GA_Info_Ptr ga_info;
+   Chrom_Ptr   kid;
+   int         i, num, phase;
+
+   ga_info = ce->ga_info;
+
+   if(ga_info->cell_sweep == CE_SYNC) {
+
+      /*--- Breed all children from the old grid ---*/
+      for(i = 0; i < ce->num_stripes; i++) ce->todo[i] = i;
+      CE_run(ce, ce->num_stripes);
+
+      /*--- Evaluate them ---*/
+      EV_batch(ga_info, ga_info->kids->chrom, ce->grid->size);
+
+      /*--- Replace every cell, unless the child is worse ---*/
+      for(i = 0; i < ce->grid->size; i++) {
+         kid = ga_info->kids->chrom[i];
+         CH_verify(ga_info, kid);
+         if(CH_cmp(ga_info, kid, ce->grid->chrom[i]) <= 0)
+            PL_insert(ce->grid, i, kid, TRUE);
+      }
+   } else {
+
+      /*--- Even stripes, odd stripes, then the last one if it is odd ---*/
+      for(phase = 0; phase < 3; phase++) {
+         for(i = 0, num = 0; i < ce->num_stripes; i++)
+            if((ce->num_stripes > 1 && ce->num_stripes % 2 != 0 &&
+                i == ce->num_stripes - 1) ? phase == 2 : phase == i % 2)
+               ce->todo[num++] = i;
+         CE_run(ce, num);
+      }
+   }
+
+   /*--- Mutation statistics ---*/
+   ga_info->num_mut = 0;
+   for(i = 0; i < ce->num_stripes; i++) {
+      ga_info->num_mut += ce->stripe[i]->num_mut;
+      ga_info->tot_mut += ce->stripe[i]->num_mut;
+      ce->stripe[i]->num_mut = 0;
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Stripe ce->todo[i]: breed children (synchronous) or sweep it (line sweep)
+----------------------------------------------------------------------------*/
+void CE_item(arg, i, id)
+   void *arg;
+   int  i, id;
+{
+   CE_Ptr      ce;
+   GA_Info_Ptr cl;
+   PR_Pool_Ptr pr;
+   Chrom_Ptr   kid;
+   int         s, cell, first, last;
+
+   ce = (CE_Ptr)arg;
+   s  = ce->todo[i];
+   cl = ce->stripe[s];
+   pr = ce->ga_info->pr_pool;
+
+   /*--- Cells of stripe ---*/
+   first = (s * ce->height / ce->num_stripes) * ce->width;
+   last  = ((s + 1) * ce->height / ce->num_stripes) * ce->width;
+
+   for(cell = first; cell < last; cell++) {
+
+      /*--- Synchronous: only breed ---*/
+      if(cl->cell_sweep == CE_SYNC) {
+         CE_breed(ce, cl, cell, ce->ga_info->kids->chrom[cell]);
+         continue;
+      }
+
+      /*--- Line sweep: breed, evaluate and replace ---*/
+      kid = cl->child1;
+      CE_breed(ce, cl, cell, kid);
+      if(PR_valid(pr)) PR_eval_on(pr, 0, &kid, 1);
+      else             cl->EV_fun(kid);
+      CH_verify(cl, kid);
+      if(CH_cmp(cl, kid, ce->grid->chrom[cell]) <= 0) {
+         CH_copy(kid, ce->grid->chrom[cell]);
+         PL_FIT(ce->grid, cell);
+      }
+   }
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Breed a child for cell with the ga_info (and stream) cl of its stripe
+----------------------------------------------------------------------------*/
+CE_breed(ce, cl, cell, kid)
+   CE_Ptr      ce;
+   GA_Info_Ptr cl;
+   int         cell;
+   Chrom_Ptr   kid;
+{
+   Chrom_Ptr parent1, parent2, a, b;
+
+   /*--- The cell and the better of two random neighbors ---*/
+   parent1 = ce->grid->chrom[cell];
+   a = ce->grid->chrom[CE_neighbor(ce, cell, RN_dom(&cl->rn, 0, ce->num_nb-1))];
+   b = ce->grid->chrom[CE_neighbor(ce, cell, RN_dom(&cl->rn, 0, ce->num_nb-1))];
+   parent2 = (CH_cmp(cl, a, b) <= 0) ? a : b;
+
+   /*--- Validate parents ---*/
+   CH_verify(cl, parent1);
+   CH_verify(cl, parent2);
+
+   /*--- Crossover (second child is not used) ---*/
+   X_fun(cl, parent1, parent2, kid, cl->child2);
+
+   /*--- Mutation ---*/
+   MU_fun(cl, kid);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Neighbor k of cell (on the torus)
+----------------------------------------------------------------------------*/
+CE_neighbor(ce, cell, k)
+   CE_Ptr ce;
+   int    cell, k;
+{
+   int r, c;
+
+   r = (cell / ce->width + CE_dr[k] + ce->height) % ce->height;
+   c = (cell % ce->width + CE_dc[k] + ce->width)  % ce->width;
+
+   return r * ce->width + c;
+}
+
+/*----------------------------------------------------------------------------
+| CE_item() for ce->todo[0..num-1], on the evaluation threads if any
+----------------------------------------------------------------------------*/
+CE_run(ce, num)
+   CE_Ptr ce;
+   int    num;
+{
+   int i;
+
+   if(TH_valid(ce->ga_info->th_pool) && num > 1) {
+      TH_run(ce->ga_info->th_pool, CE_item, (void *)ce, num);
+   } else {
+      for(i = 0; i < num; i++)
+         CE_item((void *)ce, i, 0);
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Width of a grid of size cells (if width <= 0: as square as possible)
+----------------------------------------------------------------------------*/
+CE_width(width, size)
+   int width, size;
+{
+   if(width > 0 || size <= 0) return width;
+
+   for(width = (int)sqrt((double)size); size % width != 0; width--)
+      ;
+
+   return width;
+}
@@ -13,9 +13,45 @@
 |    CH_cmp()    - compare two chromosomes
 |    CH_print()  - print a chrom
 |    CH_verify() - ensure chrom makes sense
+|
+| Gene storage
+|    CH_store()  - storage of the genes of a GA
+|    CH_size()   - bytes taken by genes
+|    CH_gene()   - value of a gene, whatever the storage
+|    CH_set()    - set a gene, whatever the storage
+|    CH_ones()   - number of genes set to 1 (popcount)
+|
+| NOTE: chromosomes of a pool usually live in its arena (see PL_arena()):
+|       chrom->arena is then the room (bytes) for genes in its row, or minus
+|       that room if the genes had to be moved to the heap by CH_resize().
+|       Such chromosomes are released, not freed, by CH_free().
+|
+| NOTE: with "packed_bits true" the genes of a bit string are stored 64 to
+|       a word (chrom->word, see CH_BIT()) instead of a Gene_Type each, and
+|       with "narrow_ints true" integer genes are shorts (chrom->i16) or,
+|       for chromosomes too long for them, ints (chrom->i32); see CH_INT().
+|       With "real_precision float" real genes are floats (chrom->f32); see
+|       CH_REAL().
+|       CH_alloc() leaves room for Gene_Type genes, which is enough for
+|       any storage; chrom->store says which one is in use.
 ============================================================================*/
 #include "ga.h"
 
+/* Number of bits set in a word */
+#ifdef __GNUC__
+#define CH_POPCOUNT(w) __builtin_popcountll(w)
+#else
+#define CH_POPCOUNT(w) CH_popcount(w)
+static int CH_popcount(w)
+   CH_Word w;
+{
+   int n;
+
+   for(n = 0; w; n++) w &= w - 1;
+   return n;
+}
+#endif
+
 /*----------------------------------------------------------------------------
 | Allocate a chromosome
 ----------------------------------------------------------------------------*/
@@ -59,10 +95,24 @@ CH_resize(chrom, length)
    if(!CH_valid(chrom)) UT_error("CH_resize: invalid chrom");
    if(length <= 0) UT_error("CH_resize: invalid length");
 
+   /*--- Genes still fit in the arena ---*/
+   if(chrom->arena > 0 && CH_size(length, chrom->store) <= chrom->arena) {
+      chrom->length = length;
+
+   /*--- Move genes out of the arena ---*/
+   } else if(chrom->arena > 0) {
+      chrom->gene = (Gene_Ptr)malloc(CH_size(length, chrom->store));
+      if(chrom->gene == NULL) UT_error("CH_resize: gene alloc failed");
+      chrom->length = length;
+      chrom->arena  = -chrom->arena;
+
    /*--- Reallocate memory for genes ---*/
-   chrom->gene = (Gene_Ptr)realloc(chrom->gene, length * sizeof(Gene_Type));
-   if(chrom->gene == NULL) UT_error("CH_resize: gene realloc failed");
-   chrom->length = length;
+   } else {
+      chrom->gene = (Gene_Ptr)realloc(chrom->gene, 
+                                      CH_size(length, chrom->store));
+      if(chrom->gene == NULL) UT_error("CH_resize: gene realloc failed");
+      chrom->length = length;
+   }
 
    /*--- Reset the chromosome ---*/
    CH_reset(chrom);
@@ -79,15 +129,15 @@ void CH_free(chrom)
 
    /*--- Free memory for genes ---*/
    if(chrom->gene != NULL) {
-      free(chrom->gene);
+      if(chrom->arena <= 0) free(chrom->gene);
       chrom->gene = NULL;
    }
 
    /*--- Put in NULL magic cookie ---*/
    chrom->magic_cookie = NL_cookie;
 
-   /*--- Free memory for chromosome ---*/
-   free(chrom);
+   /*--- Free memory for chromosome (unless in an arena) ---*/
+   if(chrom->arena == 0) free(chrom);
 }
 
 /*----------------------------------------------------------------------------
@@ -119,8 +169,11 @@ CH_reset(chrom)
    if(!CH_valid(chrom)) UT_error("CH_reset: invalid chrom");
 
    /*--- Initialize genes ---*/
-   for(i=0; i<chrom->length; i++)
-      chrom->gene[i] = (Gene_Type)0;
+   if(chrom->store == ST_DOUBLE)
+      for(i=0; i<chrom->length; i++)
+         chrom->gene[i] = (Gene_Type)0;
+   else
+      memset((char *)chrom->gene, 0, CH_size(chrom->length, chrom->store));
 
    /*--- Initialize chromosome ---*/
    chrom->fitness  = 0.0;
@@ -141,25 +194,31 @@ CH_copy(src, dst)
    Chrom_Ptr src, dst;
 {
    Gene_Ptr gene;
+   int      arena;
 
    /*--- Error check ---*/
    if(!CH_valid(src)) UT_error("CH_copy: invalid src");
    if(!CH_valid(dst)) UT_error("CH_copy: invalid dst");
 
    /*--- Resize if necessary ---*/
-   if(dst->length != src->length) CH_resize(dst, src->length);
+   if(dst->length != src->length || dst->store != src->store) {
+      dst->store = src->store;
+      CH_resize(dst, src->length);
+   }
 
    /*--- Save memory pointed to by gene ---*/
-   gene = dst->gene;
+   gene  = dst->gene;
+   arena = dst->arena;
 
    /*--- Copy chrom ---*/
    memcpy(dst, src, sizeof(Chrom_Type));
 
    /*--- Restore memory pointed to by gene ---*/
-   dst->gene = gene;
+   dst->gene  = gene;
+   dst->arena = arena;
 
    /*--- Copy gene ---*/
-   memcpy(dst->gene, src->gene, src->length * sizeof(Gene_Type));
+   memcpy(dst->gene, src->gene, CH_size(src->length, src->store));
 }
 
 /*----------------------------------------------------------------------------
@@ -202,7 +261,7 @@ CH_print(chrom)
    printf("==============================================================\n");
    printf("\nChrom: \n");
    for(i=0; i<chrom->length; i++)
-      printf("%G ", chrom->gene[i]);
+      printf("%G ", CH_gene(chrom, i));
    printf("\n\n");
    printf("fitness = %G, ptf = %G, index = %d, idx_min = %d, idx_max = %d\n", 
       chrom->fitness, chrom->ptf, chrom->index, chrom->idx_min, chrom->idx_max);
@@ -218,8 +277,9 @@ CH_verify(ga_info, chrom)
    GA_Info_Ptr ga_info;
    Chrom_Ptr chrom;
 {
-   int i;
-   char *allele_count, err_str[80];
+   int    i;
+   char   *allele_count, err_str[80];
+   double gene;
 
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("CH_verify: invalid ga_info");
@@ -253,22 +313,134 @@ CH_verify(ga_info, chrom)
    
       /*--- Check each gene in the chromosome ---*/
       for(i=0; i<chrom->length; i++) {
+         gene = chrom->store == ST_DOUBLE ? chrom->gene[i] : CH_INT(chrom, i);
 
          /*--- Check for allele out of bounds ---*/
-         if(chrom->gene[i] < 1 || (int)chrom->gene[i] > chrom->length) {
+         if(gene < 1 || (int)gene > chrom->length) {
             CH_print(chrom);
             sprintf(err_str,"CH_verify: gene[%d] = %G is out of bounds", 
-                    i, chrom->gene[i]);
+                    i, gene);
             UT_error(err_str);
 
          /*--- Check for duplicate alleles ---*/
-         } else if(++(allele_count[((int)chrom->gene[i])-1]) > 1) {
+         } else if(++(allele_count[((int)gene)-1]) > 1) {
             CH_print(chrom);
             sprintf(err_str,"CH_verify: gene[%d] = %G is a duplicate", 
-                    i, chrom->gene[i]);
+                    i, gene);
             UT_error(err_str);
          }
       }
       free(allele_count);
    }
 }
+
+/*============================================================================
+|                              Gene storage
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Storage of the genes of a GA
+----------------------------------------------------------------------------*/
+CH_store(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("CH_store: invalid ga_info");
+
+   if(ga_info->datatype == DT_BIT && ga_info->packed_bits) return ST_BITS;
+
+   /*--- Shorts hold alleles up to chrom_len for all but huge chroms ---*/
+   if((ga_info->datatype == DT_INT || ga_info->datatype == DT_INT_PERM) &&
+      ga_info->narrow_ints)
+      return ga_info->chrom_len <= 32767 ? ST_INT16 : ST_INT32;
+
+   if(ga_info->datatype == DT_REAL && ga_info->float_reals) return ST_FLOAT;
+
+   return ST_DOUBLE;
+}
+
+/*----------------------------------------------------------------------------
+| Bytes taken by length genes stored as store
+----------------------------------------------------------------------------*/
+CH_size(length, store)
+   int length, store;
+{
+   switch(store) {
+      case ST_DOUBLE: return length * sizeof(Gene_Type);
+      case ST_BITS:   return CH_WORDS(length) * sizeof(CH_Word);
+      case ST_INT16:  return length * sizeof(short);
+      case ST_INT32:  return length * sizeof(int);
+      case ST_FLOAT:  return length * sizeof(float);
+      default:        UT_error("CH_size: invalid store");
+   }
+   return 0;
+}
+
+/*----------------------------------------------------------------------------
+| Value of gene i, whatever the storage
+----------------------------------------------------------------------------*/
+double CH_gene(chrom, i)
+   Chrom_Ptr chrom;
+   int       i;
+{
+   if(chrom->store == ST_BITS) return (double)CH_BIT(chrom, i);
+   if(chrom->store == ST_FLOAT) return (double)chrom->f32[i];
+   if(chrom->store != ST_DOUBLE) return (double)CH_INT(chrom, i);
+   return chrom->gene[i];
+}
+
+/*----------------------------------------------------------------------------
+| Set gene i to value, whatever the storage
+----------------------------------------------------------------------------*/
+CH_set(chrom, i, value)
+   Chrom_Ptr chrom;
+   int       i;
+   double    value;
+{
+   CH_Word bit;
+
+   if(chrom->store == ST_BITS) {
+      bit = (CH_Word)1 << (i % CH_WORD_BITS);
+      if(value != 0.0) chrom->word[i / CH_WORD_BITS] |= bit;
+      else             chrom->word[i / CH_WORD_BITS] &= ~bit;
+   } else if(chrom->store == ST_FLOAT) {
+      chrom->f32[i] = (float)value;
+   } else if(chrom->store != ST_DOUBLE) {
+      CH_SET_INT(chrom, i, value);
+   } else {
+      chrom->gene[i] = (Gene_Type)value;
+   }
+}
+
+/*----------------------------------------------------------------------------
+| Number of genes lo..hi-1 that are 1 (a word at a time for packed bits)
+----------------------------------------------------------------------------*/
+CH_ones(chrom, lo, hi)
+   Chrom_Ptr chrom;
+   int       lo, hi;
+{
+   CH_Word mask;
+   int     i, n, w, last;
+
+   /*--- Error check ---*/
+   if(lo < 0 || hi > chrom->length) UT_error("CH_ones: bad range");
+   if(lo >= hi) return 0;
+
+   /*--- A gene at a time ---*/
+   if(chrom->store != ST_BITS) {
+      for(i = lo, n = 0; i < hi; i++)
+         if(CH_gene(chrom, i) != 0.0) n++;
+      return n;
+   }
+
+   /*--- A word at a time ---*/
+   w    = lo / CH_WORD_BITS;
+   last = (hi - 1) / CH_WORD_BITS;
+   for(n = 0; w <= last; w++) {
+      mask = ~(CH_Word)0;
+      if(w == lo / CH_WORD_BITS)  mask &= ~(CH_Word)0 << (lo % CH_WORD_BITS);
+      if(w == last && hi % CH_WORD_BITS)
+         mask &= ~(CH_Word)0 >> (CH_WORD_BITS - hi % CH_WORD_BITS);
+      n += CH_POPCOUNT(chrom->word[w] & mask);
+   }
+   return n;
+}
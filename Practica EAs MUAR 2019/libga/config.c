@@ -6,10 +6,13 @@
 | Functions:
 |    CF_alloc()    - allocate a ga_info
 |    CF_free()     - deallocate a ga_info
+|    CF_clone()    - copy the configuration of a ga_info
+|    CF_dup_fn()   - helper for CF_clone() (user defined function name)
 |    CF_valid()    - is ga_info valid?
 |    CF_reset()    - reset config
 |    CF_report()   - print out current config
 |    CF_read()     - read config file
+|    CF_line()     - process one line of a config file
 |    CF_tokenize() - convert input line to tokens
 |    CF_verify()   - ensure ga_info makes sense
 ============================================================================*/
@@ -33,6 +36,16 @@ GA_Info_Ptr CF_alloc()
    ga_info->old_pool = NULL;
    ga_info->new_pool = NULL;
    ga_info->best     = NULL;
+   ga_info->th_pool  = NULL;
+   ga_info->pr_pool  = NULL;
+   ga_info->sm       = NULL;
+   ga_info->kids     = NULL;
+   ga_info->mates    = NULL;
+   ga_info->breeder  = NULL;
+   ga_info->child1   = NULL;
+   ga_info->child2   = NULL;
+   ga_info->elite    = NULL;
+   ga_info->x_mask   = NULL;
 
    /*--- Put in a magic cookie ---*/
    ga_info->magic_cookie = CF_cookie;
@@ -54,13 +67,39 @@ void CF_free(ga_info)
 
    /*--- Free pools ---*/
    if(ga_info->old_pool != NULL) PL_free(ga_info->old_pool);
-   if(ga_info->new_pool != NULL) PL_free(ga_info->new_pool);
+   if(ga_info->new_pool != NULL && ga_info->new_pool != ga_info->old_pool)
+      PL_free(ga_info->new_pool);
    ga_info->old_pool = ga_info->new_pool = NULL;
 
    /*--- Free best chrom ---*/
    if(ga_info->best != NULL) CH_free(ga_info->best);
    ga_info->best = NULL;
 
+   /*--- Free parallel evaluation resources ---*/
+   if(ga_info->th_pool != NULL) TH_free(ga_info->th_pool);
+   if(ga_info->pr_pool != NULL) PR_free(ga_info->pr_pool);
+   if(ga_info->kids != NULL) PL_free(ga_info->kids);
+   if(ga_info->mates != NULL) free(ga_info->mates);
+   ga_info->th_pool = NULL;
+   ga_info->pr_pool = NULL;
+   ga_info->kids    = NULL;
+   ga_info->mates   = NULL;
+   BR_free(ga_info);
+
+   /*--- Free per-run work areas ---*/
+   if(ga_info->child1 != NULL) CH_free(ga_info->child1);
+   if(ga_info->child2 != NULL) CH_free(ga_info->child2);
+   if(ga_info->x_mask != NULL) free(ga_info->x_mask);
+   ga_info->child1 = ga_info->child2 = NULL;
+   ga_info->x_mask = NULL;
+
+   /*--- Free names of user defined functions ---*/
+   if(ga_info->GA_user.name != NULL) free(ga_info->GA_user.name);
+   if(ga_info->SE_user.name != NULL) free(ga_info->SE_user.name);
+   if(ga_info->X_user.name  != NULL) free(ga_info->X_user.name);
+   if(ga_info->MU_user.name != NULL) free(ga_info->MU_user.name);
+   if(ga_info->RE_user.name != NULL) free(ga_info->RE_user.name);
+
    /*--- Put in a NULL cookie ---*/
    ga_info->magic_cookie = NL_cookie;
 
@@ -68,6 +107,70 @@ void CF_free(ga_info)
    free(ga_info);
 }
 
+/*----------------------------------------------------------------------------
+| Copy a GA_Info structure
+|
+| Only the configuration is copied: the clone has no pools, no best and
+| no work space of its own yet, and continues the random number stream
+| of ga_info (use RN_jump() to give it a different one).
+----------------------------------------------------------------------------*/
+GA_Info_Ptr CF_clone(ga_info) 
+   GA_Info_Ptr ga_info;
+{
+   GA_Info_Ptr clone;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("CF_clone: invalid ga_info");
+
+   /*--- Copy everything ---*/
+   clone  = CF_alloc();
+   *clone = *ga_info;
+
+   /*--- But share nothing that is allocated ---*/
+   clone->old_pool   = NULL;
+   clone->new_pool   = NULL;
+   clone->best       = NULL;
+   clone->th_pool    = NULL;
+   clone->pr_pool    = NULL;
+   clone->sm         = NULL;
+   clone->kids       = NULL;
+   clone->mates      = NULL;
+   clone->breeder    = NULL;
+   clone->num_breeders = 0;
+   clone->child1     = NULL;
+   clone->child2     = NULL;
+   clone->elite      = NULL;
+   clone->x_mask     = NULL;
+   clone->x_mask_len = 0;
+   clone->ranked     = FALSE;
+   clone->gauss_next = FALSE;
+   CF_dup_fn(&clone->GA_user);
+   CF_dup_fn(&clone->SE_user);
+   CF_dup_fn(&clone->X_user);
+   CF_dup_fn(&clone->MU_user);
+   CF_dup_fn(&clone->RE_user);
+
+   return clone;
+}
+
+/*----------------------------------------------------------------------------
+| Give a copied user defined function its own name
+----------------------------------------------------------------------------*/
+CF_dup_fn(user)
+   FN_Table_Ptr user;
+{
+   char *name;
+
+   if(user->name == NULL) return OK;
+
+   name = (char *)calloc(strlen(user->name) + 1, sizeof(char));
+   if(name == NULL) UT_error("CF_dup_fn: alloc failed");
+   strcpy(name, user->name);
+   user->name = name;
+
+   return OK;
+}
+
 /*----------------------------------------------------------------------------
 | Is a ga_info valid, i.e., has it been allocated by CF_alloc()?
 ----------------------------------------------------------------------------*/
@@ -96,7 +199,11 @@ CF_reset(ga_info)
    /*--- Default basic parameters ---*/
    ga_info->user_data[0]    = '\0';
    ga_info->rand_seed       = 1;
+   RN_seed(&ga_info->rn, ga_info->rand_seed);
    ga_info->datatype        = DT_INT_PERM;
+   ga_info->packed_bits     = FALSE;
+   ga_info->narrow_ints     = FALSE;
+   ga_info->float_reals     = FALSE;
    ga_info->ip_flag         = IP_RANDOM;
    ga_info->ip_data[0]      = '\0';
    ga_info->chrom_len       = 10;
@@ -112,6 +219,33 @@ CF_reset(ga_info)
    ga_info->elitist         = TRUE;
    ga_info->converged       = FALSE;
    ga_info->use_convergence = TRUE;
+   ga_info->eval_threads    = 1;
+   ga_info->eval_procs      = 0;
+   ga_info->eval_cmd[0]     = '\0';
+   ga_info->par_repro       = FALSE;
+   ga_info->deterministic   = FALSE;
+   ga_info->batch           = 2;
+   ga_info->se_ready        = FALSE;
+
+   /*--- Default island model ---*/
+   ga_info->islands         = 4;
+   ga_info->isl_steady      = FALSE;
+   ga_info->mig_interval    = 10;
+   ga_info->mig_size        = 1;
+   ga_info->mig_topology    = MG_RING;
+   ga_info->mig_replace     = MG_WORST;
+   ga_info->net_role        = NT_NONE;
+   strcpy(ga_info->net_host, "localhost");
+   ga_info->net_port        = 5555;
+
+   /*--- Default cellular GA ---*/
+   ga_info->grid_width      = 0;
+   ga_info->cell_nbhd       = CE_VON_NEUMANN;
+   ga_info->cell_sweep      = CE_SYNC;
+
+   /*--- Default pool monitor in shared memory (none) ---*/
+   ga_info->shm_name[0]     = '\0';
+   ga_info->shm_interval    = 1;
 
    /*--- Default operators ---*/
    SE_select(ga_info, "roulette");
@@ -124,6 +258,7 @@ CF_reset(ga_info)
    /*--- Default report parameters ---*/
    ga_info->rp_type      = RP_SHORT;
    ga_info->rp_interval  = 1;
+   ga_info->rp_chroms    = -1;
    ga_info->rp_fid       = stdout;
    ga_info->rp_file[0]   = '\0';
 
@@ -143,6 +278,7 @@ CF_report(ga_info)
 {
    FILE *fid;
    char *sptr;
+   int  i;
 
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("CF_report: invalid ga_info");
@@ -168,6 +304,16 @@ CF_report(ga_info)
       case DT_REAL:     fprintf(fid,"Real\n"); break;
       default:          fprintf(fid,"Unspecified\n"); break;
    }
+   switch(CH_store(ga_info)) {
+      case ST_BITS:  fprintf(fid,"   Gene Storage      : Packed bits\n");
+                     break;
+      case ST_INT16: fprintf(fid,"   Gene Storage      : 16 bit ints\n");
+                     break;
+      case ST_INT32: fprintf(fid,"   Gene Storage      : 32 bit ints\n");
+                     break;
+      case ST_FLOAT: fprintf(fid,"   Gene Storage      : Floats\n");
+                     break;
+   }
    fprintf(fid,"   Init Pool Entered : ");
    switch(ga_info->ip_flag) {
       case IP_RANDOM     : fprintf(fid,"Randomly     \n"); break;
@@ -200,6 +346,22 @@ CF_report(ga_info)
    fprintf(fid,"   Elitism           : %s\n", 
       ga_info->elitist ? "Yes" : "No");
    fprintf(fid,"   Scale Factor      : %G\n", ga_info->scale_factor);
+   if(ga_info->eval_procs > 0)
+      fprintf(fid,"   Eval Processes    : %d\n", ga_info->eval_procs);
+   else if(ga_info->eval_threads > 1)
+      fprintf(fid,"   Eval Threads      : %d\n", ga_info->eval_threads);
+   if(ga_info->eval_procs > 0 && ga_info->eval_cmd[0] != '\0')
+      fprintf(fid,"   Eval Command      : %s\n", ga_info->eval_cmd);
+   if(ga_info->par_repro)
+      fprintf(fid,"   Parallel Repro    : Yes\n");
+   if(ga_info->deterministic)
+      fprintf(fid,"   Deterministic     : Yes\n");
+   if(ga_info->batch > 2)
+      fprintf(fid,"   Batch             : %d children per iteration\n",
+              ga_info->batch);
+   if(ga_info->shm_name[0] != '\0')
+      fprintf(fid,"   Pool Monitor      : %s, every %d iterations\n",
+              ga_info->shm_name, ga_info->shm_interval);
 
    /*--- Functions ---*/
    fprintf(fid,"\n");
@@ -216,6 +378,47 @@ CF_report(ga_info)
          MU_name(ga_info), ga_info->mu_rate);
    fprintf(fid,"   Replacement : %s\n", RE_name(ga_info));
 
+   /*--- Island model ---*/
+   if(!strcmp(GA_name(ga_info), "islands")) {
+      fprintf(fid,"\n");
+      fprintf(fid,"Islands\n");
+      fprintf(fid,"   Number      : %d of %d chromosomes (%s)\n", 
+         ga_info->islands, ga_info->pool_size,
+         ga_info->isl_steady ? "steady_state" : "generational");
+      fprintf(fid,"   Migration   : %d every %d iterations\n", 
+         ga_info->mig_size, ga_info->mig_interval);
+      fprintf(fid,"   Topology    : %s\n", 
+         ga_info->mig_topology == MG_RING  ? "ring"  :
+         ga_info->mig_topology == MG_TORUS ? "torus" :
+         ga_info->mig_topology == MG_FULL  ? "full"  :
+         "Unknown");
+      fprintf(fid,"   Replace     : %s\n", 
+         ga_info->mig_replace == MG_WORST  ? "worst"  :
+         ga_info->mig_replace == MG_RANDOM ? "random" :
+         "Unknown");
+      if(ga_info->net_role != NT_NONE)
+         fprintf(fid,"   Net Role    : %s (coordinator at %s:%d)\n", 
+            ga_info->net_role == NT_COORDINATOR ? "coordinator" : "island",
+            ga_info->net_host, ga_info->net_port);
+   }
+
+   /*--- Cellular GA ---*/
+   if(!strcmp(GA_name(ga_info), "cellular")) {
+      fprintf(fid,"\n");
+      fprintf(fid,"Cellular\n");
+      i = CE_width(ga_info->grid_width, ga_info->pool_size);
+      if(i > 0)
+         fprintf(fid,"   Grid        : %d x %d\n", i, ga_info->pool_size / i);
+      fprintf(fid,"   Neighbors   : %s\n", 
+         ga_info->cell_nbhd == CE_VON_NEUMANN ? "von_neumann" :
+         ga_info->cell_nbhd == CE_MOORE       ? "moore"       :
+         "Unknown");
+      fprintf(fid,"   Update      : %s\n", 
+         ga_info->cell_sweep == CE_SYNC  ? "synchronous" :
+         ga_info->cell_sweep == CE_SWEEP ? "line_sweep"  :
+         "Unknown");
+   }
+
    /*--- Reports ---*/
    if(ga_info->rp_type != RP_NONE) {
       fprintf(fid,"\n");
@@ -226,6 +429,8 @@ CF_report(ga_info)
          ga_info->rp_type == RP_LONG    ? "Long"    :
          "Unknown");
       fprintf(fid,"   Interval : %d\n", ga_info->rp_interval);
+      if(ga_info->rp_type == RP_LONG && ga_info->rp_chroms >= 0)
+         fprintf(fid,"   Listed   : %d chromosomes\n", ga_info->rp_chroms);
       if(ga_info->rp_file[0] != 0) {
          fprintf(fid,"   File  : ");
          if(!strcmp(ga_info->rp_file, "UNSPECIFIED"))
@@ -249,8 +454,7 @@ CF_read(ga_info, cfg_name)
    GA_Info_Ptr ga_info;
    char        *cfg_name;
 {
-   char str[STRLEN], token[MAXTOK][STRLEN];
-   int  numtok, CF_tokenize();
+   char str[STRLEN];
    FILE *fid;
 
    /*--- Error check ---*/
@@ -263,251 +467,438 @@ CF_read(ga_info, cfg_name)
    }
 
    /*--- Read each line from config file ---*/
-   while(fgets(str, STRLEN, fid) != NULL) {
-
-      /*--- Convert to tokens ---*/
-      if((numtok=CF_tokenize(str, token)) <= 0) continue;
-
-      /*--- Which command? ---*/
-      switch(token[0][0]) {
-
-      case 'b': 
-         if(!strcmp(token[0], "bias")) {
-            if(numtok >= 2 && sscanf(token[1], "%f", &ga_info->bias) == 1)
-               ;
-            else
-               UT_warn("CF_read: Invalid bias response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
-
-      case 'c': 
-         if(!strcmp(token[0], "chrom_len")) {
-            if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->chrom_len) == 1)
-               ;
-            else
-               UT_warn("CF_read: Invalid chrom_len response");
-         } else if(!strcmp(token[0], "crossover")) {
-            if(numtok >= 2)
-               X_select(ga_info, token[1]);
-            else
-               UT_warn("CF_read: Invalid crossover response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
-
-      case 'd': 
-         if(!strcmp(token[0], "datatype")) {
-            if(numtok >= 2 && !strcmp(token[1], "bit")) 
-               ga_info->datatype = DT_BIT;
-            else if(numtok >= 2 && !strcmp(token[1], "int")) 
-               ga_info->datatype = DT_INT;
-            else if(numtok >= 2 && !strcmp(token[1], "int_perm")) 
-               ga_info->datatype = DT_INT_PERM;
-            else if(numtok >= 2 && !strcmp(token[1], "real")) 
-               ga_info->datatype = DT_REAL;
-            else
-               UT_warn("CF_read: Invalid datatype response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
-
-      case 'e': 
-         if(!strcmp(token[0], "elitism")) {
-            if(numtok >= 2 && !strcmp(token[1], "true"))
-               ga_info->elitist = TRUE;
-            else if(numtok >= 2 && !strcmp(token[1], "false"))
-               ga_info->elitist = FALSE;
-            else
-               UT_warn("CF_read: Invalid elitism response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+   while(fgets(str, STRLEN, fid) != NULL)
+      CF_line(ga_info, str);
 
-      case 'g': 
-         if(!strcmp(token[0], "gap")) {
-            if(numtok >= 2 && sscanf(token[1], "%f", &ga_info->gap) == 1)
-               ;
-            else
-               UT_warn("CF_read: Invalid gap response");
-         } else if(!strcmp(token[0], "ga")) {
-            if(numtok >= 2) {
-               GA_select(ga_info, token[1]);
-               if(!strcmp(token[1], "generational")) {
-                  SE_select(ga_info, "roulette");
-                  RE_select(ga_info, "append");
-                  ga_info->rp_interval = 1;
-               } else if(!strcmp(token[1], "steady_state")) {
-                  SE_select(ga_info, "rank_biased");
-                  RE_select(ga_info, "by_rank");
-                  ga_info->rp_interval = 100;
-               }
-            } else
-               UT_warn("CF_read: Invalid ga response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+   /*--- PATCH 1 BEGIN ---*/
+   /* Many thanks to Paul-Erik Raue (peraue@cs.vu.nl) 
+    * for finding this bug. 
+    * 
+    * Close the configuration file 
+    */
+   fclose(fid);
+   /*--- PATCH 1 END ---*/
+}
 
-      case 'i': 
-         if(!strcmp(token[0], "initpool")) {
-            if(numtok >= 2 && !strcmp(token[1], "random")) 
-               ga_info->ip_flag = IP_RANDOM;
-            if(numtok >= 2 && !strcmp(token[1], "random01")) 
-	      ga_info->ip_flag = IP_RANDOM01;
-            else if(numtok >= 2 && !strcmp(token[1], "from_file")) {
-               ga_info->ip_flag = IP_FROM_FILE;
-               if(numtok >= 3) strcpy(ga_info->ip_data, token[2]);
-            } else if(numtok >= 2 && !strcmp(token[1], "interactive")) 
-               ga_info->ip_flag = IP_INTERACTIVE;
-            else
-               UT_warn("CF_read: Invalid initpool response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+/*----------------------------------------------------------------------------
+| Process one line of a config file (e.g. "x_rate 0.8")
+----------------------------------------------------------------------------*/
+CF_line(ga_info, str)
+   GA_Info_Ptr ga_info;
+   char        *str;
+{
+   char token[MAXTOK][STRLEN];
+   int  numtok, i, CF_tokenize();
 
-      case 'm': 
-         if(!strcmp(token[0], "mutation")) {
-            if(numtok >= 2) 
-               MU_select(ga_info, token[1]);
-            else
-               UT_warn("CF_read: Invalid mutation response");
-         } else if(!strcmp(token[0], "mu_rate")) {
-            if(numtok >= 2)
-               sscanf(token[1], "%f", &ga_info->mu_rate);
-            else
-               UT_warn("CF_read: Invalid mu_rate response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("CF_line: invalid ga_info");
 
-      case 'o': 
-         if(!strcmp(token[0], "objective")) {
-            if(numtok >= 2 && !strcmp(token[1], "minimize"))
-               ga_info->minimize = TRUE;
-            else if(numtok >= 2 && !strcmp(token[1], "maximize"))
-               ga_info->minimize = FALSE;
-            else
-               UT_warn("CF_read: Invalid objective response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+   /*--- Convert to tokens ---*/
+   if((numtok=CF_tokenize(str, token)) <= 0) return OK;
 
-      case 'p': 
-         if(!strcmp(token[0], "pool_size")) {
-            if(numtok >= 2)
-               sscanf(token[1], "%d", &ga_info->pool_size);
-            else
-               UT_warn("CF_read: Invalid pool_size response");
-         } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+   /*--- Which command? ---*/
+   switch(token[0][0]) {
 
-      case 'r': 
-         if(!strcmp(token[0], "replacement")) {
-            if(numtok >= 2)
-               RE_select(ga_info, token[1]);
-            else
-               UT_warn("CF_read: Invalid replacement response");
-         } else if(!strcmp(token[0], "rp_interval")) {
-            if(numtok >= 2)
-               sscanf(token[1], "%d", &ga_info->rp_interval);
-            else
-               UT_warn("CF_read: Invalid rp_interval response");
-         } else if(!strcmp(token[0], "rp_type")) {
-            if(numtok >= 2 && !strcmp(token[1], "minimal"))
-               ga_info->rp_type = RP_MINIMAL;
-            else if(numtok >= 2 && !strcmp(token[1], "short"))
-               ga_info->rp_type = RP_SHORT;
-            else if(numtok >= 2 && !strcmp(token[1], "long"))
-               ga_info->rp_type = RP_LONG;
-            else if(numtok >= 2 && !strcmp(token[1], "none"))
-               ga_info->rp_type = RP_NONE;
-            else
-               UT_warn("CF_read: Invalid rp_type response");
-         } else if(!strcmp(token[0], "rp_file")) {
-            if(numtok >= 2) {
-               char *file_mode = "a";
-
-               /*--- Save file name ---*/
-               strcpy(ga_info->rp_file, token[1]);
-
-               /*--- Get file mode if provided ---*/
-               if(numtok >= 3)
-                  file_mode = token[2];
-
-               /*--- Open report file ---*/
-               ga_info->rp_fid = fopen(ga_info->rp_file, file_mode);
-               if(ga_info->rp_fid == NULL)
-                  UT_error("CF_read: error opening report file");
-            } else
-               UT_warn("CF_read: Invalid rp_file response");
-         } else if(!strcmp(token[0], "rand_seed")) {
-            if(numtok >= 2 && !strcmp(token[1], "my_pid"))
-               ga_info->rand_seed = getpid();
-            else if(numtok >= 2)
-               sscanf(token[1], "%d", &ga_info->rand_seed);
-            else
-               UT_warn("CF_read: Invalid rand_seed response");
+   case 'b': 
+      if(!strcmp(token[0], "bias")) {
+         if(numtok >= 2 && sscanf(token[1], "%f", &ga_info->bias) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid bias response");
+      } else if(!strcmp(token[0], "batch")) {
+         if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->batch) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid batch response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'c': 
+      if(!strcmp(token[0], "chrom_len")) {
+         if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->chrom_len) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid chrom_len response");
+      } else if(!strcmp(token[0], "crossover")) {
+         if(numtok >= 2)
+            X_select(ga_info, token[1]);
+         else
+            UT_warn("CF_read: Invalid crossover response");
+      } else if(!strcmp(token[0], "cell_update")) {
+         if(numtok >= 2 && !strcmp(token[1], "synchronous"))
+            ga_info->cell_sweep = CE_SYNC;
+         else if(numtok >= 2 && !strcmp(token[1], "line_sweep"))
+            ga_info->cell_sweep = CE_SWEEP;
+         else
+            UT_warn("CF_read: Invalid cell_update response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'd': 
+      if(!strcmp(token[0], "datatype")) {
+         if(numtok >= 2 && !strcmp(token[1], "bit")) 
+            ga_info->datatype = DT_BIT;
+         else if(numtok >= 2 && !strcmp(token[1], "int")) 
+            ga_info->datatype = DT_INT;
+         else if(numtok >= 2 && !strcmp(token[1], "int_perm")) 
+            ga_info->datatype = DT_INT_PERM;
+         else if(numtok >= 2 && !strcmp(token[1], "real")) 
+            ga_info->datatype = DT_REAL;
+         else
+            UT_warn("CF_read: Invalid datatype response");
+      } else if(!strcmp(token[0], "deterministic")) {
+         if(numtok >= 2 && !strcmp(token[1], "true"))
+            ga_info->deterministic = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "false"))
+            ga_info->deterministic = FALSE;
+         else
+            UT_warn("CF_read: Invalid deterministic response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'e': 
+      if(!strcmp(token[0], "elitism")) {
+         if(numtok >= 2 && !strcmp(token[1], "true"))
+            ga_info->elitist = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "false"))
+            ga_info->elitist = FALSE;
+         else
+            UT_warn("CF_read: Invalid elitism response");
+      } else if(!strcmp(token[0], "eval_threads")) {
+         if(numtok >= 2 && 
+            sscanf(token[1], "%d", &ga_info->eval_threads) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid eval_threads response");
+      } else if(!strcmp(token[0], "eval_procs")) {
+         if(numtok >= 2 && 
+            sscanf(token[1], "%d", &ga_info->eval_procs) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid eval_procs response");
+      } else if(!strcmp(token[0], "eval_cmd")) {
+         if(numtok >= 2) {
+            strcpy(ga_info->eval_cmd, token[1]);
+            for(i = 2; i < numtok; i++) {
+               strcat(ga_info->eval_cmd, " ");
+               strcat(ga_info->eval_cmd, token[i]);
+            }
          } else
-            UT_warn("CF_read: Unknown config command");
-         break;
-
-      case 's': 
-         if(!strcmp(token[0], "selection")) {
-            if(numtok >= 2)
-               SE_select(ga_info, token[1]);
-            else
-               UT_warn("CF_read: Invalid selection response");
-         } else if(!strcmp(token[0], "stop_after")) {
-            if(numtok == 2 && !strcmp(token[1], "convergence")) {
-               ga_info->use_convergence = TRUE;
-               ga_info->max_iter = -1;
-            } else if(numtok >= 2) {
-               sscanf(token[1], "%d", &ga_info->max_iter);
-               if(ga_info->max_iter < 1) 
-                  UT_warn("CF_read: Invalid number for stop_after");
-               ga_info->use_convergence = TRUE;
-               if(numtok > 2 && !strcmp(token[2], "ignore_convergence"))
-                  ga_info->use_convergence = FALSE;
-            } else {
-               UT_warn("CF_read: Invalid stop_after response");
+            UT_warn("CF_read: Invalid eval_cmd response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'g': 
+      if(!strcmp(token[0], "gap")) {
+         if(numtok >= 2 && sscanf(token[1], "%f", &ga_info->gap) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid gap response");
+      } else if(!strcmp(token[0], "grid_width")) {
+         if(numtok >= 2 && 
+            sscanf(token[1], "%d", &ga_info->grid_width) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid grid_width response");
+      } else if(!strcmp(token[0], "ga")) {
+         if(numtok >= 2) {
+            GA_select(ga_info, token[1]);
+            if(!strcmp(token[1], "generational") ||
+               !strcmp(token[1], "cellular")) {
+               SE_select(ga_info, "roulette");
+               RE_select(ga_info, "append");
+               ga_info->rp_interval = 1;
+            } else if(!strcmp(token[1], "steady_state") ||
+                      !strcmp(token[1], "async_steady_state")) {
+               SE_select(ga_info, "rank_biased");
+               RE_select(ga_info, "by_rank");
+               ga_info->rp_interval = 100;
             }
          } else
-            UT_warn("CF_read: Unknown config command");
-         break;
-
-      case 'u': 
-         if(!strcmp(token[0], "user_data")) {
-            if(numtok >= 2)
-               strcpy(ga_info->user_data, token[1]);
-            else
-               UT_warn("CF_read: Invalid user_data response");
+            UT_warn("CF_read: Invalid ga response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'i': 
+      if(!strcmp(token[0], "islands")) {
+         if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->islands) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid islands response");
+      } else if(!strcmp(token[0], "island_ga")) {
+         if(numtok >= 2 && !strcmp(token[1], "generational")) {
+            ga_info->isl_steady = FALSE;
+            SE_select(ga_info, "roulette");
+            RE_select(ga_info, "append");
+         } else if(numtok >= 2 && !strcmp(token[1], "steady_state")) {
+            ga_info->isl_steady = TRUE;
+            SE_select(ga_info, "rank_biased");
+            RE_select(ga_info, "by_rank");
          } else
-            UT_warn("CF_read: Unknown config command");
-         break;
-
-      case 'x': 
-         if(!strcmp(token[0], "x_rate")) {
-            if(numtok >= 2 && sscanf(token[1], "%f", &ga_info->x_rate) == 1)
-               ;
-            else
-               UT_warn("CF_read: Invalid x_rate response");
+            UT_warn("CF_read: Invalid island_ga response");
+      } else if(!strcmp(token[0], "initpool")) {
+         if(numtok >= 2 && !strcmp(token[1], "random")) 
+            ga_info->ip_flag = IP_RANDOM;
+         else if(numtok >= 2 && !strcmp(token[1], "random01")) 
+	      ga_info->ip_flag = IP_RANDOM01;
+         else if(numtok >= 2 && !strcmp(token[1], "from_file")) {
+            ga_info->ip_flag = IP_FROM_FILE;
+            if(numtok >= 3) strcpy(ga_info->ip_data, token[2]);
+         } else if(numtok >= 2 && !strcmp(token[1], "interactive")) 
+            ga_info->ip_flag = IP_INTERACTIVE;
+         else
+            UT_warn("CF_read: Invalid initpool response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'm': 
+      if(!strcmp(token[0], "mutation")) {
+         if(numtok >= 2) 
+            MU_select(ga_info, token[1]);
+         else
+            UT_warn("CF_read: Invalid mutation response");
+      } else if(!strcmp(token[0], "mu_rate")) {
+         if(numtok >= 2)
+            sscanf(token[1], "%f", &ga_info->mu_rate);
+         else
+            UT_warn("CF_read: Invalid mu_rate response");
+      } else if(!strcmp(token[0], "mig_interval")) {
+         if(numtok >= 2 && 
+            sscanf(token[1], "%d", &ga_info->mig_interval) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid mig_interval response");
+      } else if(!strcmp(token[0], "mig_size")) {
+         if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->mig_size) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid mig_size response");
+      } else if(!strcmp(token[0], "mig_topology")) {
+         if(numtok >= 2 && !strcmp(token[1], "ring"))
+            ga_info->mig_topology = MG_RING;
+         else if(numtok >= 2 && !strcmp(token[1], "torus"))
+            ga_info->mig_topology = MG_TORUS;
+         else if(numtok >= 2 && !strcmp(token[1], "full"))
+            ga_info->mig_topology = MG_FULL;
+         else
+            UT_warn("CF_read: Invalid mig_topology response");
+      } else if(!strcmp(token[0], "mig_replace")) {
+         if(numtok >= 2 && !strcmp(token[1], "worst"))
+            ga_info->mig_replace = MG_WORST;
+         else if(numtok >= 2 && !strcmp(token[1], "random"))
+            ga_info->mig_replace = MG_RANDOM;
+         else
+            UT_warn("CF_read: Invalid mig_replace response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'n': 
+      if(!strcmp(token[0], "neighborhood")) {
+         if(numtok >= 2 && !strcmp(token[1], "von_neumann"))
+            ga_info->cell_nbhd = CE_VON_NEUMANN;
+         else if(numtok >= 2 && !strcmp(token[1], "moore"))
+            ga_info->cell_nbhd = CE_MOORE;
+         else
+            UT_warn("CF_read: Invalid neighborhood response");
+      } else if(!strcmp(token[0], "net_role")) {
+         if(numtok >= 2 && !strcmp(token[1], "none"))
+            ga_info->net_role = NT_NONE;
+         else if(numtok >= 2 && !strcmp(token[1], "coordinator"))
+            ga_info->net_role = NT_COORDINATOR;
+         else if(numtok >= 2 && !strcmp(token[1], "island"))
+            ga_info->net_role = NT_ISLAND;
+         else
+            UT_warn("CF_read: Invalid net_role response");
+      } else if(!strcmp(token[0], "net_host")) {
+         if(numtok >= 2)
+            strcpy(ga_info->net_host, token[1]);
+         else
+            UT_warn("CF_read: Invalid net_host response");
+      } else if(!strcmp(token[0], "net_port")) {
+         if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->net_port) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid net_port response");
+      } else if(!strcmp(token[0], "narrow_ints")) {
+         if(numtok >= 2 && !strcmp(token[1], "true"))
+            ga_info->narrow_ints = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "false"))
+            ga_info->narrow_ints = FALSE;
+         else
+            UT_warn("CF_read: Invalid narrow_ints response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'o': 
+      if(!strcmp(token[0], "objective")) {
+         if(numtok >= 2 && !strcmp(token[1], "minimize"))
+            ga_info->minimize = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "maximize"))
+            ga_info->minimize = FALSE;
+         else
+            UT_warn("CF_read: Invalid objective response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'p': 
+      if(!strcmp(token[0], "pool_size")) {
+         if(numtok >= 2)
+            sscanf(token[1], "%d", &ga_info->pool_size);
+         else
+            UT_warn("CF_read: Invalid pool_size response");
+      } else if(!strcmp(token[0], "packed_bits")) {
+         if(numtok >= 2 && !strcmp(token[1], "true"))
+            ga_info->packed_bits = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "false"))
+            ga_info->packed_bits = FALSE;
+         else
+            UT_warn("CF_read: Invalid packed_bits response");
+      } else if(!strcmp(token[0], "parallel_repro")) {
+         if(numtok >= 2 && !strcmp(token[1], "true"))
+            ga_info->par_repro = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "false"))
+            ga_info->par_repro = FALSE;
+         else
+            UT_warn("CF_read: Invalid parallel_repro response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'r': 
+      if(!strcmp(token[0], "replacement")) {
+         if(numtok >= 2)
+            RE_select(ga_info, token[1]);
+         else
+            UT_warn("CF_read: Invalid replacement response");
+      } else if(!strcmp(token[0], "rp_interval")) {
+         if(numtok >= 2)
+            sscanf(token[1], "%d", &ga_info->rp_interval);
+         else
+            UT_warn("CF_read: Invalid rp_interval response");
+      } else if(!strcmp(token[0], "rp_chroms")) {
+         if(numtok >= 2 && !strcmp(token[1], "all"))
+            ga_info->rp_chroms = -1;
+         else if(numtok >= 2 && sscanf(token[1], "%d", &ga_info->rp_chroms) == 1
+                 && ga_info->rp_chroms >= 0)
+            ;
+         else
+            UT_warn("CF_read: Invalid rp_chroms response");
+      } else if(!strcmp(token[0], "rp_type")) {
+         if(numtok >= 2 && !strcmp(token[1], "minimal"))
+            ga_info->rp_type = RP_MINIMAL;
+         else if(numtok >= 2 && !strcmp(token[1], "short"))
+            ga_info->rp_type = RP_SHORT;
+         else if(numtok >= 2 && !strcmp(token[1], "long"))
+            ga_info->rp_type = RP_LONG;
+         else if(numtok >= 2 && !strcmp(token[1], "none"))
+            ga_info->rp_type = RP_NONE;
+         else
+            UT_warn("CF_read: Invalid rp_type response");
+      } else if(!strcmp(token[0], "rp_file")) {
+         if(numtok >= 2) {
+            char *file_mode = "a";
+
+            /*--- Save file name ---*/
+            strcpy(ga_info->rp_file, token[1]);
+
+            /*--- Get file mode if provided ---*/
+            if(numtok >= 3)
+               file_mode = token[2];
+
+            /*--- Open report file ---*/
+            ga_info->rp_fid = fopen(ga_info->rp_file, file_mode);
+            if(ga_info->rp_fid == NULL)
+               UT_error("CF_read: error opening report file");
          } else
-            UT_warn("CF_read: Unknown config command");
-         break;
+            UT_warn("CF_read: Invalid rp_file response");
+      } else if(!strcmp(token[0], "rand_seed")) {
+         if(numtok >= 2 && !strcmp(token[1], "my_pid"))
+            ga_info->rand_seed = getpid();
+         else if(numtok >= 2)
+            sscanf(token[1], "%d", &ga_info->rand_seed);
+         else
+            UT_warn("CF_read: Invalid rand_seed response");
+      } else if(!strcmp(token[0], "real_precision")) {
+         if(numtok >= 2 && !strcmp(token[1], "float"))
+            ga_info->float_reals = TRUE;
+         else if(numtok >= 2 && !strcmp(token[1], "double"))
+            ga_info->float_reals = FALSE;
+         else
+            UT_warn("CF_read: Invalid real_precision response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 's': 
+      if(!strcmp(token[0], "selection")) {
+         if(numtok >= 2)
+            SE_select(ga_info, token[1]);
+         else
+            UT_warn("CF_read: Invalid selection response");
+      } else if(!strcmp(token[0], "stop_after")) {
+         if(numtok == 2 && !strcmp(token[1], "convergence")) {
+            ga_info->use_convergence = TRUE;
+            ga_info->max_iter = -1;
+         } else if(numtok >= 2) {
+            sscanf(token[1], "%d", &ga_info->max_iter);
+            if(ga_info->max_iter < 1) 
+               UT_warn("CF_read: Invalid number for stop_after");
+            ga_info->use_convergence = TRUE;
+            if(numtok > 2 && !strcmp(token[2], "ignore_convergence"))
+               ga_info->use_convergence = FALSE;
+         } else {
+            UT_warn("CF_read: Invalid stop_after response");
+         }
+      } else if(!strcmp(token[0], "shm_name")) {
+         if(numtok >= 2 && strcmp(token[1], "none"))
+            strcpy(ga_info->shm_name, token[1]);
+         else if(numtok >= 2)
+            ga_info->shm_name[0] = '\0';
+         else
+            UT_warn("CF_read: Invalid shm_name response");
+      } else if(!strcmp(token[0], "shm_interval")) {
+         if(numtok >= 2)
+            sscanf(token[1], "%d", &ga_info->shm_interval);
+         else
+            UT_warn("CF_read: Invalid shm_interval response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'u': 
+      if(!strcmp(token[0], "user_data")) {
+         if(numtok >= 2)
+            strcpy(ga_info->user_data, token[1]);
+         else
+            UT_warn("CF_read: Invalid user_data response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
+
+   case 'x': 
+      if(!strcmp(token[0], "x_rate")) {
+         if(numtok >= 2 && sscanf(token[1], "%f", &ga_info->x_rate) == 1)
+            ;
+         else
+            UT_warn("CF_read: Invalid x_rate response");
+      } else
+         UT_warn("CF_read: Unknown config command");
+      break;
 
-      default:
-            UT_warn("CF_read: Unknown config command");
-      }
+   default:
+         UT_warn("CF_read: Unknown config command");
    }
-   /*--- PATCH 1 BEGIN ---*/
-   /* Many thanks to Paul-Erik Raue (peraue@cs.vu.nl) 
-    * for finding this bug. 
-    * 
-    * Close the configuration file 
-    */
-   fclose(fid);
-   /*--- PATCH 1 END ---*/
+
+   return OK;
 }
 
 /*----------------------------------------------------------------------------
@@ -562,6 +953,7 @@ CF_verify(ga_info)
          break;
       case IP_INTERACTIVE:
       case IP_RANDOM:
+      case IP_RANDOM01:
       case IP_NONE:
          break;
       default: UT_error("CF_verify: Invalid ip_flag");
@@ -617,4 +1009,92 @@ CF_verify(ga_info)
 
    if(ga_info->rp_interval <= 0)
       UT_error("CF_verify: invalid report interval");
+
+   if(ga_info->eval_threads <= 0)
+      UT_error("CF_verify: invalid number of evaluation threads");
+
+   if(ga_info->eval_procs < 0)
+      UT_error("CF_verify: invalid number of evaluation processes");
+
+   if(ga_info->eval_cmd[0] != '\0' && ga_info->eval_procs <= 0)
+      UT_error("CF_verify: eval_cmd needs eval_procs");
+
+   if(CH_store(ga_info) != ST_DOUBLE) {
+      if(ga_info->ip_flag != IP_RANDOM && ga_info->ip_flag != IP_RANDOM01)
+         UT_error("CF_verify: packed/narrow genes need a random initpool");
+      if(CH_store(ga_info) == ST_BITS &&
+         ga_info->X_fun != ga_info->X_user.fun &&
+         strcmp(X_name(ga_info), "simple") && 
+         strcmp(X_name(ga_info), "uniform"))
+         UT_error("CF_verify: packed_bits needs simple or uniform crossover");
+      if(ga_info->MU_fun != NULL && ga_info->MU_fun != ga_info->MU_user.fun &&
+         strcmp(MU_name(ga_info), "swap") &&
+         (CH_store(ga_info) == ST_FLOAT ?
+            strncmp(MU_name(ga_info), "float_", 6) != 0 :
+            strcmp(MU_name(ga_info), "simple_invert") &&
+            strcmp(MU_name(ga_info), "simple_random")))
+         UT_error("CF_verify: mutation cannot handle this gene storage");
+      if(ga_info->eval_procs > 0 || ga_info->shm_name[0] != '\0' ||
+         ga_info->net_role != NT_NONE)
+         UT_error("CF_verify: packed/narrow genes need in-process evaluation");
+   }
+
+   if(ga_info->batch < 2 || ga_info->batch % 2 != 0)
+      UT_error("CF_verify: batch must be an even number, at least 2");
+
+   if(ga_info->islands <= 0)
+      UT_error("CF_verify: invalid number of islands");
+
+   if(ga_info->mig_interval <= 0)
+      UT_error("CF_verify: invalid migration interval");
+
+   if(ga_info->mig_size < 0 || ga_info->mig_size >= ga_info->pool_size)
+      UT_error("CF_verify: invalid migration size");
+
+   switch(ga_info->mig_topology) {
+      case MG_RING:
+      case MG_TORUS:
+      case MG_FULL:
+         break;
+      default: UT_error("CF_verify: Invalid migration topology");
+   }
+
+   switch(ga_info->mig_replace) {
+      case MG_WORST:
+      case MG_RANDOM:
+         break;
+      default: UT_error("CF_verify: Invalid migration replacement");
+   }
+
+   switch(ga_info->net_role) {
+      case NT_NONE:
+      case NT_COORDINATOR:
+      case NT_ISLAND:
+         break;
+      default: UT_error("CF_verify: Invalid net_role");
+   }
+
+   if(ga_info->net_port <= 0 || ga_info->net_port > 65535)
+      UT_error("CF_verify: invalid net_port");
+
+   if(ga_info->shm_interval <= 0)
+      UT_error("CF_verify: invalid shm_interval");
+
+   if(ga_info->grid_width < 0 || (ga_info->grid_width > 0 &&
+      ga_info->pool_size % ga_info->grid_width != 0))
+      UT_error("CF_verify: pool size is not a multiple of grid width");
+
+   switch(ga_info->cell_nbhd) {
+      case CE_VON_NEUMANN:
+      case CE_MOORE:
+         break;
+      default: UT_error("CF_verify: Invalid neighborhood");
+   }
+
+   switch(ga_info->cell_sweep) {
+      case CE_SYNC:
+      case CE_SWEEP:
+         break;
+      default: UT_error("CF_verify: Invalid cell update");
+   }
 }
@@ -31,8 +31,14 @@
 |    X_gen_4_xp()  - generate four sorted, random crossover points
 |    X_init_kids() - reset children for crossover
 |    X_map()       - find allele in a chromosome
+|    X_find()      - find integer allele in a chromosome
 |
 | NOTE: Crossover points should always be thought of as "inclusive"
+|
+| NOTE: X_simple() and X_uniform() also take packed bit strings (ST_BITS),
+|       a word of 64 genes at a time, with the same children and random
+|       numbers as gene by gene.  All operators take narrow integer genes
+|       (ST_INT16, ST_INT32) through CH_MOVE() and CH_INT().
 ============================================================================*/
 #include "ga.h"
 
@@ -68,7 +74,8 @@ X_set_fun(ga_info, fn_name, fn_ptr)
    char         *fn_name;
    FN_Ptr       fn_ptr;
 {
-   return FN_set_fun(ga_info, X_table, fn_name, fn_ptr, &ga_info->X_fun);
+   return FN_set_fun(ga_info, &ga_info->X_user, fn_name, fn_ptr, 
+                     &ga_info->X_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -78,7 +85,8 @@ X_select(ga_info, fn_name)
    GA_Info_Ptr  ga_info;
    char         *fn_name;
 {
-   return FN_select(ga_info, X_table, fn_name, &ga_info->X_fun);
+   return FN_select(ga_info, X_table, &ga_info->X_user, fn_name, 
+                    &ga_info->X_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -87,7 +95,7 @@ X_select(ga_info, fn_name)
 char *X_name(ga_info)
    GA_Info_Ptr  ga_info;
 {
-   return FN_name(ga_info, X_table, ga_info->X_fun);
+   return FN_name(ga_info, X_table, &ga_info->X_user, ga_info->X_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -102,7 +110,7 @@ X_fun(ga_info, parent_1, parent_2, child_1, child_2)
    X_init_kids(parent_1, parent_2, child_1, child_2);
 
    /*--- Clone instead of crossover ---*/
-   if(ga_info->x_rate < 1.0 && RAND_FRAC() > ga_info->x_rate) {
+   if(ga_info->x_rate < 1.0 && RN_frac(&ga_info->rn) > ga_info->x_rate) {
       CH_copy(parent_1, child_1);
       CH_copy(parent_2, child_2);
       child_1->parent_1 = parent_1->index;
@@ -137,6 +145,7 @@ X_simple(ga_info, parent_1, parent_2, child_1, child_2)
 {
    unsigned i, xp;
    Gene_Type tmp;
+   CH_Word   mask;
 
    /*--- Make sure datatype is compatible ---*/
    if(ga_info->datatype == DT_INT_PERM)
@@ -147,20 +156,34 @@ X_simple(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("crossover: heterozygous parents");
 
    /*--- Random crossover point ---*/
-   X_gen_xp(0, parent_1->length-1, &xp);
+   X_gen_xp(&ga_info->rn, 0, parent_1->length-1, &xp);
    child_1->xp1 = xp;
    child_2->xp1 = xp;
 
+   /*--- Packed bits: whole words, then the word with the point ---*/
+   if(parent_1->store == ST_BITS) {
+      for(i = 0; i < CH_WORDS(parent_1->length); i++) {
+         if(i < xp / CH_WORD_BITS)      mask = ~(CH_Word)0;
+         else if(i > xp / CH_WORD_BITS) mask = 0;
+         else mask = ~(CH_Word)0 >> (CH_WORD_BITS - 1 - xp % CH_WORD_BITS);
+         child_1->word[i] = (parent_1->word[i] & mask) |
+                            (parent_2->word[i] & ~mask);
+         child_2->word[i] = (parent_2->word[i] & mask) |
+                            (parent_1->word[i] & ~mask);
+      }
+      return OK;
+   }
+
    /*--- Half is same as parent ---*/
    for(i = 0; i <= xp; i++) {
-      child_1->gene[i] = parent_1->gene[i];
-      child_2->gene[i] = parent_2->gene[i];
+      CH_MOVE(child_1, i, parent_1, i);
+      CH_MOVE(child_2, i, parent_2, i);
    }
 
    /*--- Other half is swapped ---*/
    for(i = xp+1; i < parent_1->length; i++) {
-      child_1->gene[i] = parent_2->gene[i];
-      child_2->gene[i] = parent_1->gene[i];
+      CH_MOVE(child_1, i, parent_2, i);
+      CH_MOVE(child_2, i, parent_1, i);
    }
 
    return OK;
@@ -177,6 +200,7 @@ X_uniform(ga_info, parent_1, parent_2, child_1, child_2)
    Chrom_Ptr  child_1, child_2;
 {
    unsigned i;
+   CH_Word  mask;
 
    /*--- Make sure datatype is compatible ---*/
    if(ga_info->datatype == DT_INT_PERM)
@@ -186,13 +210,26 @@ X_uniform(ga_info, parent_1, parent_2, child_1, child_2)
    if(parent_1->length != parent_2->length)
       UT_error("crossover: heterozygous parents");
 
+   /*--- Packed bits: a random mask per word ---*/
+   if(parent_1->store == ST_BITS) {
+      for(i = 0; i < CH_WORDS(parent_1->length); i++) {
+         mask = RN_bits(&ga_info->rn, 
+                        MIN(CH_WORD_BITS, parent_1->length - i*CH_WORD_BITS));
+         child_1->word[i] = (parent_1->word[i] & mask) |
+                            (parent_2->word[i] & ~mask);
+         child_2->word[i] = (parent_2->word[i] & mask) |
+                            (parent_1->word[i] & ~mask);
+      }
+      return OK;
+   }
+
    for(i = 0; i < parent_1->length; i++) {
-      if(RAND_BIT()) {
-         child_1->gene[i] = parent_1->gene[i];
-         child_2->gene[i] = parent_2->gene[i];
+      if(RN_bit(&ga_info->rn)) {
+         CH_MOVE(child_1, i, parent_1, i);
+         CH_MOVE(child_2, i, parent_2, i);
       } else {
-         child_1->gene[i] = parent_2->gene[i];
-         child_2->gene[i] = parent_1->gene[i];
+         CH_MOVE(child_1, i, parent_2, i);
+         CH_MOVE(child_2, i, parent_1, i);
       }
    }
 
@@ -229,14 +266,14 @@ X_order1(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("crossover: heterozygous parents");
 
    /*--- Select two sorted crossover points ---*/
-   X_gen_2_xp(FALSE, 0, parent_1->length, &xp1, &xp2);
+   X_gen_2_xp(&ga_info->rn, FALSE, 0, parent_1->length, &xp1, &xp2);
    child_1->xp1 = child_2->xp1 = xp1;
    child_1->xp2 = child_2->xp2 = xp2;
 
    /*--- Info between xp is same as parent ---*/
    for(i = xp1; i <= xp2; i++) {
-      child_1->gene[i] = parent_1->gene[i];
-      child_2->gene[i] = parent_2->gene[i];
+      CH_MOVE(child_1, i, parent_1, i);
+      CH_MOVE(child_2, i, parent_2, i);
    }
 
    /*--- Inherit remainder from other parent ---*/
@@ -248,18 +285,18 @@ X_order1(ga_info, parent_1, parent_2, child_1, child_2)
       /*--- Child 1 gets next unused element in parent 2 ---*/
       while(TRUE) {
          p2 = (p2 + 1) % parent_1->length;
-         if(X_map(&parent_2->gene[p2], parent_1, xp1, xp2) < 0) break;
+         if(X_find(CH_INT(parent_2, p2), parent_1, xp1, xp2) < 0) break;
       }
 
       /*--- Child 2 gets next unused element in parent 1 ---*/
       while(TRUE) {
          p1 = (p1 + 1) % parent_2->length;
-         if(X_map(&parent_1->gene[p1], parent_2, xp1, xp2) < 0) break;
+         if(X_find(CH_INT(parent_1, p1), parent_2, xp1, xp2) < 0) break;
       }
 
       /*--- Transfer to children ---*/
-      child_1->gene[c] = parent_2->gene[p2];
-      child_2->gene[c] = parent_1->gene[p1];
+      CH_MOVE(child_1, c, parent_2, p2);
+      CH_MOVE(child_2, c, parent_1, p1);
    }
 
    return OK; 
@@ -293,45 +330,46 @@ X_order2(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("crossover: heterozygous parents");
 
    /*--- Select four sorted crossover points ---*/
-   X_gen_4_xp(TRUE, 0, parent_1->length, &xp1, &xp2, &xp3, &xp4);
+   X_gen_4_xp(&ga_info->rn, TRUE, 0, parent_1->length, 
+              &xp1, &xp2, &xp3, &xp4);
    child_1->xp1 = xp1; child_1->xp2 = xp2;
    child_2->xp1 = xp3; child_2->xp2 = xp4;
 
    /*--- Children look like parents ---*/
    for (i=0; i < parent_1->length; i++) {
-      child_1->gene[i] = parent_1->gene[i];
-      child_2->gene[i] = parent_2->gene[i];
+      CH_MOVE(child_1, i, parent_1, i);
+      CH_MOVE(child_2, i, parent_2, i);
    }
 
    /*--- Map order of xp's in other parent ---*/
    for (i=0, j1=j2=0; i < parent_1->length; i++) {
 
       /*--- Child_1 uses order in parent_2 ---*/
-      if( (int)parent_2->gene[i] == (int)parent_1->gene[xp1] || 
-          (int)parent_2->gene[i] == (int)parent_1->gene[xp2] ||
-          (int)parent_2->gene[i] == (int)parent_1->gene[xp3] ||
-          (int)parent_2->gene[i] == (int)parent_1->gene[xp4]     ) {
+      if( CH_INT(parent_2, i) == CH_INT(parent_1, xp1) || 
+          CH_INT(parent_2, i) == CH_INT(parent_1, xp2) ||
+          CH_INT(parent_2, i) == CH_INT(parent_1, xp3) ||
+          CH_INT(parent_2, i) == CH_INT(parent_1, xp4)     ) {
          xidx_1[j1++] = i;
       }
 
       /*--- Child_2 uses order in parent_1 ---*/
-      if( (int)parent_1->gene[i] == (int)parent_2->gene[xp1] || 
-          (int)parent_1->gene[i] == (int)parent_2->gene[xp2] ||
-          (int)parent_1->gene[i] == (int)parent_2->gene[xp3] ||
-          (int)parent_1->gene[i] == (int)parent_2->gene[xp4]     ) {
+      if( CH_INT(parent_1, i) == CH_INT(parent_2, xp1) || 
+          CH_INT(parent_1, i) == CH_INT(parent_2, xp2) ||
+          CH_INT(parent_1, i) == CH_INT(parent_2, xp3) ||
+          CH_INT(parent_1, i) == CH_INT(parent_2, xp4)     ) {
          xidx_2[j2++] = i;
       }
    }
 
    /*--- Impose ordering of xp's from other parent ---*/
-   child_1->gene[xp1] = parent_2->gene[xidx_1[0]];
-   child_1->gene[xp2] = parent_2->gene[xidx_1[1]];
-   child_1->gene[xp3] = parent_2->gene[xidx_1[2]];
-   child_1->gene[xp4] = parent_2->gene[xidx_1[3]];
-   child_2->gene[xp1] = parent_1->gene[xidx_2[0]];
-   child_2->gene[xp2] = parent_1->gene[xidx_2[1]];
-   child_2->gene[xp3] = parent_1->gene[xidx_2[2]];
-   child_2->gene[xp4] = parent_1->gene[xidx_2[3]];
+   CH_MOVE(child_1, xp1, parent_2, xidx_1[0]);
+   CH_MOVE(child_1, xp2, parent_2, xidx_1[1]);
+   CH_MOVE(child_1, xp3, parent_2, xidx_1[2]);
+   CH_MOVE(child_1, xp4, parent_2, xidx_1[3]);
+   CH_MOVE(child_2, xp1, parent_1, xidx_2[0]);
+   CH_MOVE(child_2, xp2, parent_1, xidx_2[1]);
+   CH_MOVE(child_2, xp3, parent_1, xidx_2[2]);
+   CH_MOVE(child_2, xp4, parent_1, xidx_2[3]);
 
    return OK; 
 }
@@ -365,45 +403,46 @@ X_pos(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("crossover: heterozygous parents");
 
    /*--- Select four sorted crossover points ---*/
-   X_gen_4_xp(FALSE, 0, parent_1->length, &xp1, &xp2, &xp3, &xp4);
+   X_gen_4_xp(&ga_info->rn, FALSE, 0, parent_1->length, 
+              &xp1, &xp2, &xp3, &xp4);
    child_1->xp1 = xp1; child_1->xp2 = xp2;
    child_2->xp1 = xp3; child_2->xp2 = xp4;
 
    /*--- Children get parent's xp values ---*/
-   child_1->gene[xp1] = parent_1->gene[xp1];
-   child_1->gene[xp2] = parent_1->gene[xp2];
-   child_1->gene[xp3] = parent_1->gene[xp3];
-   child_1->gene[xp4] = parent_1->gene[xp4];
-   child_2->gene[xp1] = parent_2->gene[xp1];
-   child_2->gene[xp2] = parent_2->gene[xp2];
-   child_2->gene[xp3] = parent_2->gene[xp3];
-   child_2->gene[xp4] = parent_2->gene[xp4];
+   CH_MOVE(child_1, xp1, parent_1, xp1);
+   CH_MOVE(child_1, xp2, parent_1, xp2);
+   CH_MOVE(child_1, xp3, parent_1, xp3);
+   CH_MOVE(child_1, xp4, parent_1, xp4);
+   CH_MOVE(child_2, xp1, parent_2, xp1);
+   CH_MOVE(child_2, xp2, parent_2, xp2);
+   CH_MOVE(child_2, xp3, parent_2, xp3);
+   CH_MOVE(child_2, xp4, parent_2, xp4);
 
    /*--- Inherit rest using order from other parent ---*/
    for (i=0, j1=j2=0; i < parent_1->length; i++) {
 
       /*--- Transfer if not a crossover point (child_1) ---*/
-      if( (int)parent_2->gene[i] != (int)parent_1->gene[xp1] && 
-          (int)parent_2->gene[i] != (int)parent_1->gene[xp2] &&
-          (int)parent_2->gene[i] != (int)parent_1->gene[xp3] && 
-          (int)parent_2->gene[i] != (int)parent_1->gene[xp4]   ) {
+      if( CH_INT(parent_2, i) != CH_INT(parent_1, xp1) && 
+          CH_INT(parent_2, i) != CH_INT(parent_1, xp2) &&
+          CH_INT(parent_2, i) != CH_INT(parent_1, xp3) && 
+          CH_INT(parent_2, i) != CH_INT(parent_1, xp4)   ) {
 
          /*--- Make sure j1 is not a crossover point ---*/
          while(j1 == xp1 || j1 == xp2 || j1 == xp3 || j1 == xp4) j1++;
 
-         child_1->gene[j1++] = parent_2->gene[i];
+         CH_MOVE(child_1, j1++, parent_2, i);
       }
 
       /*--- Transfer if not a crossover point (child_2) ---*/
-      if( (int)parent_1->gene[i] != (int)parent_2->gene[xp1] && 
-          (int)parent_1->gene[i] != (int)parent_2->gene[xp2] &&
-          (int)parent_1->gene[i] != (int)parent_2->gene[xp3] && 
-          (int)parent_1->gene[i] != (int)parent_2->gene[xp4]   ) {
+      if( CH_INT(parent_1, i) != CH_INT(parent_2, xp1) && 
+          CH_INT(parent_1, i) != CH_INT(parent_2, xp2) &&
+          CH_INT(parent_1, i) != CH_INT(parent_2, xp3) && 
+          CH_INT(parent_1, i) != CH_INT(parent_2, xp4)   ) {
 
          /*--- Make sure j2 is not a crossover point ---*/
          while(j2 == xp1 || j2 == xp2 || j2 == xp3 || j2 == xp4) j2++;
 
-         child_2->gene[j2++] = parent_1->gene[i];
+         CH_MOVE(child_2, j2++, parent_1, i);
       }
    }
 
@@ -442,27 +481,27 @@ X_cycle(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("crossover: heterozygous parents");
 
    /*--- Select crossover point ---*/
-   X_gen_xp(0, parent_1->length, &xp);
+   X_gen_xp(&ga_info->rn, 0, parent_1->length, &xp);
    child_1->xp1 = xp;
    child_2->xp1 = xp;
 
    /*--- Transfer material to children ---*/
    for(i = 0; i < parent_1->length; i++) {
-      child_1->gene[i] = parent_2->gene[i];
-      child_2->gene[i] = parent_1->gene[i];
+      CH_MOVE(child_1, i, parent_2, i);
+      CH_MOVE(child_2, i, parent_1, i);
    }
 
    /*--- Crossover (child 1) ---*/
    for (i=xp; ; ) {
-      child_1->gene[i] = parent_1->gene[i];
-      i = X_map(&parent_2->gene[i], parent_1, 0, parent_1->length - 1);
+      CH_MOVE(child_1, i, parent_1, i);
+      i = X_find(CH_INT(parent_2, i), parent_1, 0, parent_1->length - 1);
       if(i == xp) break;
    }
 
    /*--- Crossover (child 2) ---*/
    for (i=xp; ; ) {
-      child_2->gene[i] = parent_2->gene[i];
-      i = X_map(&parent_1->gene[i], parent_2, 0, parent_2->length - 1);
+      CH_MOVE(child_2, i, parent_2, i);
+      i = X_find(CH_INT(parent_1, i), parent_2, 0, parent_2->length - 1);
       if(i == xp) break;
    }
 
@@ -500,18 +539,18 @@ X_pmx(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("crossover: heterozygous parents");
 
    /*--- Select two sorted crossover points ---*/
-   X_gen_2_xp(FALSE, 0, parent_1->length, &xp1, &xp2);
+   X_gen_2_xp(&ga_info->rn, FALSE, 0, parent_1->length, &xp1, &xp2);
    child_1->xp1 = child_2->xp1 = xp1; 
    child_1->xp2 = child_2->xp2 = xp2;
 
    /*--- Copy info to children ---*/
    for(i = 0; i < parent_1->length; i++) {
       if(i < xp1 || i > xp2) {
-         child_1->gene[i] = parent_1->gene[i];
-         child_2->gene[i] = parent_2->gene[i];
+         CH_MOVE(child_1, i, parent_1, i);
+         CH_MOVE(child_2, i, parent_2, i);
       } else {
-         child_1->gene[i] = parent_2->gene[i];
-         child_2->gene[i] = parent_1->gene[i];
+         CH_MOVE(child_1, i, parent_2, i);
+         CH_MOVE(child_2, i, parent_1, i);
       }
    }
 
@@ -522,19 +561,19 @@ X_pmx(ga_info, parent_1, parent_2, child_1, child_2)
       if(i >= xp1 && i <= xp2) continue;
 
       /*--- A mapped element (child_1) ---*/
-      if((j = X_map(&child_1->gene[i], child_1, xp1, xp2)) >= 0) {
+      if((j = X_find(CH_INT(child_1, i), child_1, xp1, xp2)) >= 0) {
          while(TRUE) {
-            child_1->gene[i] = parent_1->gene[j];
-            if((j = X_map(&child_1->gene[i], child_1, xp1, xp2)) < 0) 
+            CH_MOVE(child_1, i, parent_1, j);
+            if((j = X_find(CH_INT(child_1, i), child_1, xp1, xp2)) < 0) 
                break;
          }
       }
 
       /*--- A mapped element (child_2) ---*/
-      if((j = X_map(&child_2->gene[i], child_2, xp1, xp2)) >= 0) {
+      if((j = X_find(CH_INT(child_2, i), child_2, xp1, xp2)) >= 0) {
          while(TRUE) {
-            child_2->gene[i] = parent_2->gene[j];
-            if((j = X_map(&child_2->gene[i], child_2, xp1, xp2)) < 0) 
+            CH_MOVE(child_2, i, parent_2, j);
+            if((j = X_find(CH_INT(child_2, i), child_2, xp1, xp2)) < 0) 
                break;
          }
       }
@@ -554,9 +593,7 @@ X_uox(ga_info, parent_1, parent_2, child_1, child_2)
    Chrom_Ptr  child_1, child_2;
 {
    unsigned i, j1, j2;
-   int length;
-   static int  m1_length, m2_length;
-   static char *m1 = NULL, *m2 = NULL;
+   char     *mask;
 
    /*--- Make sure datatype is compatible ---*/
    if(ga_info->datatype != DT_INT_PERM)
@@ -566,68 +603,57 @@ X_uox(ga_info, parent_1, parent_2, child_1, child_2)
    if(parent_1->length != parent_2->length)
       UT_error("crossover: heterozygous parents");
 
-   /*--- Make room for m1 ---*/
-   if(m1 == NULL) {
-      m1 = (char *)calloc(parent_1->length, sizeof(char));
-      if(m1 == NULL) UT_error("X_uox: m1 alloc failed");
-      m1_length = parent_1->length;
-   } else {
-      if(m1_length != parent_1->length) {
-         m1 = (char *)realloc(m1, parent_1->length * sizeof(char));
-         if(m1 == NULL) UT_error("X_uox: m1 realloc failed");
-         m1_length = parent_1->length;
-      }
+   /*--- Make room for mask (kept in ga_info between calls) ---*/
+   if(ga_info->x_mask == NULL) {
+      ga_info->x_mask = (char *)calloc(parent_1->length, sizeof(char));
+      if(ga_info->x_mask == NULL) UT_error("X_uox: mask alloc failed");
+      ga_info->x_mask_len = parent_1->length;
+   } else if(ga_info->x_mask_len != parent_1->length) {
+      ga_info->x_mask = (char *)realloc(ga_info->x_mask, 
+                                        parent_1->length * sizeof(char));
+      if(ga_info->x_mask == NULL) UT_error("X_uox: mask realloc failed");
+      ga_info->x_mask_len = parent_1->length;
    }
+   mask = ga_info->x_mask;
 
-   /*--- Make room for m2 ---*/
-   if(m2 == NULL) {
-      m2 = (char *)calloc(parent_2->length, sizeof(char));
-      if(m2 == NULL) UT_error("X_uox: m2 alloc failed");
-      m2_length = parent_2->length;
-   } else {
-      if(m2_length != parent_2->length) {
-         m2 = (char *)realloc(m2, parent_2->length * sizeof(char));
-         if(m2 == NULL) UT_error("X_uox: m2 realloc failed");
-         m2_length = parent_2->length;
-      }
-   }
-
-   /*--- Random mask ---*/
+   /*--- Random mask (same for both children) ---*/
    for(i = 0; i < parent_1->length; i++) {
-      m1[i] = m2[i] = (RAND_BIT() ? 1 : 0);
+      mask[i] = (RN_bit(&ga_info->rn) ? 1 : 0);
    }
 
    /*--- Place alleles from mask ---*/
    for(i = 0; i < parent_1->length; i++) {
-      if(m1[i]) child_1->gene[i] = parent_1->gene[i];
-      else      child_1->gene[i] = -1;
+      if(mask[i]) CH_MOVE(child_1, i, parent_1, i);
+      else        CH_SET_INT(child_1, i, -1);
    }
    for(i = 0; i < parent_2->length; i++) {
-      if(m2[i]) child_2->gene[i] = parent_2->gene[i];
-      else      child_2->gene[i] = -1;
+      if(mask[i]) CH_MOVE(child_2, i, parent_2, i);
+      else        CH_SET_INT(child_2, i, -1);
    }
 
    /*--- Place remaining alleles ---*/
    j1 = 0;
    for(i = 0; i < parent_1->length; i++) {
-      if((int)child_1->gene[i] == -1) {
-         while(X_map(&parent_2->gene[j1], child_1, 0, child_1->length-1) != -1)
+      if(CH_INT(child_1, i) == -1) {
+         while(X_find(CH_INT(parent_2, j1), child_1, 0, 
+                      child_1->length-1) != -1)
             if(j1 < parent_2->length)
                j1++;
             else
                UT_error("X_uox: invalid j1");
-         child_1->gene[i] = parent_2->gene[j1];
+         CH_MOVE(child_1, i, parent_2, j1);
       }
    }
    j2 = 0;
    for(i = 0; i < parent_2->length; i++) {
-      if((int)child_2->gene[i] == -1) {
-         while(X_map(&parent_1->gene[j2], child_2, 0, child_2->length-1) != -1)
+      if(CH_INT(child_2, i) == -1) {
+         while(X_find(CH_INT(parent_1, j2), child_2, 0, 
+                      child_2->length-1) != -1)
             if(j2 < parent_1->length)
                j2++;
             else
                UT_error("X_uox: invalid j2");
-         child_2->gene[i] = parent_1->gene[j2];
+         CH_MOVE(child_2, i, parent_1, j2);
       }
    }
 }
@@ -680,8 +706,8 @@ X_asex(ga_info, parent_1, parent_2, child_1, child_2)
       UT_error("X_asex: bad data type");
 
    /*--- Perform asexual crossover ---*/
-   X_do_asex(parent_1, child_1);
-   X_do_asex(parent_2, child_2);
+   X_do_asex(&ga_info->rn, parent_1, child_1);
+   X_do_asex(&ga_info->rn, parent_2, child_2);
 
    return OK;
 }
@@ -691,7 +717,8 @@ X_asex(ga_info, parent_1, parent_2, child_1, child_2)
 |
 | Perform asexual crossover for X_asex()
 ----------------------------------------------------------------------------*/
-X_do_asex(parent, child)
+X_do_asex(rn, parent, child)
+   RN_Ptr     rn;
    Chrom_Ptr  parent;
    Chrom_Ptr  child;
 {
@@ -699,7 +726,7 @@ X_do_asex(parent, child)
 
    /*--- Copy info to child ---*/
    for(i = 0; i < parent->length; i++) {
-      child->gene[i] = parent->gene[i];
+      CH_MOVE(child, i, parent, i);
    }
    child->idx_min = parent->idx_min;
 
@@ -707,13 +734,13 @@ X_do_asex(parent, child)
    if(parent->idx_min >= parent->length-1) return OK;
 
    /*--- Select two sorted crossover points ---*/
-   X_gen_2_xp(TRUE, parent->idx_min, parent->length, &xp1, &xp2);
+   X_gen_2_xp(rn, TRUE, parent->idx_min, parent->length, &xp1, &xp2);
    child->xp1 = xp1; 
    child->xp2 = xp2;
 
    /*--- Crossover just swaps xp's ---*/
-   child->gene[xp1] = parent->gene[xp2];
-   child->gene[xp2] = parent->gene[xp1];
+   CH_MOVE(child, xp1, parent, xp2);
+   CH_MOVE(child, xp2, parent, xp1);
 
    return OK;
 }
@@ -724,26 +751,28 @@ X_do_asex(parent, child)
 /*----------------------------------------------------------------------------
 | Generate crossover point in [idx_min..idx_max-1]
 ----------------------------------------------------------------------------*/
-X_gen_xp(idx_min, idx_max, xp)
-   int idx_min, idx_max, *xp;
+X_gen_xp(rn, idx_min, idx_max, xp)
+   RN_Ptr rn;
+   int    idx_min, idx_max, *xp;
 {
-   *xp = RAND_DOM(idx_min, idx_max - 1);
+   *xp = RN_dom(rn, idx_min, idx_max - 1);
 }
 
 /*----------------------------------------------------------------------------
 | Generate two sorted crossover points
 ----------------------------------------------------------------------------*/
-X_gen_2_xp(unique, idx_min, idx_max, xp1, xp2)
-   int unique, idx_min, idx_max, *xp1, *xp2;
+X_gen_2_xp(rn, unique, idx_min, idx_max, xp1, xp2)
+   RN_Ptr rn;
+   int    unique, idx_min, idx_max, *xp1, *xp2;
 {
    /*--- Generate two points ---*/
-   X_gen_xp(idx_min, idx_max, xp1);
-   X_gen_xp(idx_min, idx_max, xp2);
+   X_gen_xp(rn, idx_min, idx_max, xp1);
+   X_gen_xp(rn, idx_min, idx_max, xp2);
 
    /*--- Make sure unique if specified ---*/
    if(unique) {
       while(*xp2 == *xp1) 
-         X_gen_xp(idx_min, idx_max, xp2);
+         X_gen_xp(rn, idx_min, idx_max, xp2);
    }
 
    /*--- Make sure they are sorted ---*/
@@ -754,25 +783,26 @@ X_gen_2_xp(unique, idx_min, idx_max, xp1, xp2)
 /*----------------------------------------------------------------------------
 | Generate four sorted crossover points
 ----------------------------------------------------------------------------*/
-X_gen_4_xp(unique, idx_min, idx_max, xp1, xp2, xp3, xp4)
-   int unique, idx_min, idx_max, *xp1, *xp2, *xp3, *xp4;
+X_gen_4_xp(rn, unique, idx_min, idx_max, xp1, xp2, xp3, xp4)
+   RN_Ptr rn;
+   int    unique, idx_min, idx_max, *xp1, *xp2, *xp3, *xp4;
 {
    /*--- Generate four points ---*/
-   X_gen_xp(idx_min, idx_max, xp1);
-   X_gen_xp(idx_min, idx_max, xp2);
-   X_gen_xp(idx_min, idx_max, xp3);
-   X_gen_xp(idx_min, idx_max, xp4);
+   X_gen_xp(rn, idx_min, idx_max, xp1);
+   X_gen_xp(rn, idx_min, idx_max, xp2);
+   X_gen_xp(rn, idx_min, idx_max, xp3);
+   X_gen_xp(rn, idx_min, idx_max, xp4);
 
    /*--- Make sure unique if specified ---*/
    if(unique) {
       while(*xp2 == *xp1) 
-         X_gen_xp(idx_min, idx_max, xp2);
+         X_gen_xp(rn, idx_min, idx_max, xp2);
 
       while(*xp3 == *xp1 || *xp3 == *xp2) 
-         X_gen_xp(idx_min, idx_max, xp3);
+         X_gen_xp(rn, idx_min, idx_max, xp3);
 
       while(*xp4 == *xp1 || *xp4 == *xp2 || *xp4 == *xp3) 
-         X_gen_xp(idx_min, idx_max, xp4);
+         X_gen_xp(rn, idx_min, idx_max, xp4);
    }
 
    /*--- Make sure they are sorted (use "sorting network") ---*/
@@ -795,6 +825,18 @@ X_init_kids(parent_1, parent_2, child_1, child_2)
    if(parent_2->length <= 0) UT_error("crossover: parent_2->length");
    if(child_1 == NULL) UT_error("X_init_kids: null child_1");
    if(child_2 == NULL) UT_error("X_init_kids: null child_2");
+   if(parent_1->store != parent_2->store) 
+      UT_error("crossover: parents stored differently");
+
+   /*--- Children are stored as the parents are ---*/
+   if(child_1->store != parent_1->store) {
+      child_1->store = parent_1->store;
+      CH_resize(child_1, child_1->length);
+   }
+   if(child_2->store != parent_1->store) {
+      child_2->store = parent_1->store;
+      CH_resize(child_2, child_2->length);
+   }
 
    /*--- Initialize the children ---*/
    CH_reset(child_1);
@@ -812,17 +854,40 @@ X_map(allele, chrom, lo, hi)
    Gene_Type  *allele;
    Chrom_Ptr  chrom;
    int lo, hi;
+{
+   return X_find((int)*allele, chrom, lo, hi);
+}
+
+/*----------------------------------------------------------------------------
+| Find integer allele in chrom genes lo..hi (-1 if not there), a loop per
+| storage so the search runs on the genes as they are stored
+----------------------------------------------------------------------------*/
+X_find(allele, chrom, lo, hi)
+   int        allele;
+   Chrom_Ptr  chrom;
+   int        lo, hi;
 {
    int i;
 
    /*--- Error check ---*/
    if(lo < 0 || lo > hi || hi >= chrom->length) 
-      UT_error("X_map: bad range");
+      UT_error("X_find: bad range");
 
    /*--- Find allele in range of genes ---*/
-   for(i = lo; i <= hi; i++) 
-      if((int)*allele == (int)chrom->gene[i]) 
-         return i;
+   switch(chrom->store) {
+      case ST_DOUBLE:
+         for(i = lo; i <= hi; i++) 
+            if(allele == (int)chrom->gene[i]) return i;
+         break;
+      case ST_INT16:
+         for(i = lo; i <= hi; i++) 
+            if(allele == chrom->i16[i]) return i;
+         break;
+      case ST_INT32:
+         for(i = lo; i <= hi; i++) 
+            if(allele == chrom->i32[i]) return i;
+         break;
+   }
 
    /*--- Not found ---*/
    return -1;
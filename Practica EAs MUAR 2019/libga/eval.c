@@ -0,0 +1,98 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Evaluation of several chromosomes at once
+|
+| Functions:
+|    EV_batch() - evaluate an array of chromosomes
+|    EV_item()  - helper for EV_batch() (one chromosome)
+|    EV_pair()  - evaluate two chromosomes (children of a trial)
+|
+| NOTE: With eval_threads > 1 the user's EV_fun is called from several
+|       threads at the same time and must therefore be thread safe.
+|       With eval_procs > 0 it is called by other processes instead (see
+|       proc.c), which is safe for any EV_fun.
+============================================================================*/
+#include "ga.h"
+
+/*--- What each thread needs to evaluate its share ---*/
+typedef struct {
+   GA_Info_Ptr ga_info;
+   Chrom_Ptr   *chrom;
+} EV_Job_Type, *EV_Job_Ptr;
+
+void EV_item();
+
+/*----------------------------------------------------------------------------
+| Evaluate chrom[0..num-1], in parallel if there is a process or thread pool
+----------------------------------------------------------------------------*/
+EV_batch(ga_info, chrom, num)
+   GA_Info_Ptr ga_info;
+   Chrom_Ptr   *chrom;
+   int         num;
+{
+   EV_Job_Type job;
+   int         i;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("EV_batch: invalid ga_info");
+   if(ga_info->EV_fun == NULL) UT_error("EV_batch: null EV_fun");
+   if(num > 0 && chrom == NULL) UT_error("EV_batch: null chrom");
+
+   /*--- Processes ---*/
+   if(PR_valid(ga_info->pr_pool)) {
+      PR_eval(ga_info->pr_pool, chrom, num);
+      return OK;
+   }
+
+   /*--- Sequential ---*/
+   if(!TH_valid(ga_info->th_pool) || num <= 1) {
+      for(i = 0; i < num; i++)
+         ga_info->EV_fun(chrom[i]);
+      return OK;
+   }
+
+   /*--- Parallel ---*/
+   job.ga_info = ga_info;
+   job.chrom   = chrom;
+   TH_run(ga_info->th_pool, EV_item, (void *)&job, num);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Evaluate one chromosome of an EV_batch() job
+----------------------------------------------------------------------------*/
+void EV_item(arg, i, id)
+   void *arg;
+   int  i, id;
+{
+   EV_Job_Ptr job;
+
+   job = (EV_Job_Ptr)arg;
+   job->ga_info->EV_fun(job->chrom[i]);
+}
+
+/*----------------------------------------------------------------------------
+| Evaluate c1 and c2 (by the processes, if any, else right here)
+----------------------------------------------------------------------------*/
+EV_pair(ga_info, c1, c2)
+   GA_Info_Ptr ga_info;
+   Chrom_Ptr   c1, c2;
+{
+   Chrom_Ptr pair[2];
+
+   /*--- Processes ---*/
+   if(PR_valid(ga_info->pr_pool)) {
+      pair[0] = c1;
+      pair[1] = c2;
+      PR_eval(ga_info->pr_pool, pair, 2);
+      return OK;
+   }
+
+   /*--- Right here ---*/
+   ga_info->EV_fun(c1);
+   ga_info->EV_fun(c2);
+
+   return OK;
+}
@@ -0,0 +1,162 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Experiments: replicate runs of one configuration
+|
+| Functions:
+|    EX_replicate() - run a GA several times with different seeds
+|    EX_item()      - helper for EX_replicate() (one run)
+|    EX_csv()       - write results of EX_replicate() as CSV
+|    EX_clock()     - wall clock time in seconds
+|
+| NOTE: The runs are done in parallel, each with a ga_info of its own (see
+|       CF_clone()), so the evaluation function MUST be thread safe.
+============================================================================*/
+#include "ga.h"
+#include <sys/time.h>
+#include <unistd.h>
+
+/*--- What each run needs ---*/
+typedef struct {
+   GA_Info_Ptr   ga_info;   /* Configuration to run */
+   EX_Result_Ptr res;       /* Results, by run */
+} EX_Job_Type, *EX_Job_Ptr;
+
+void EX_item();
+
+/*----------------------------------------------------------------------------
+| Run the GA of ga_info num times, with seeds rand_seed, rand_seed+1, ...,
+| using num_threads threads (all processors if num_threads <= 0)
+|
+| ga_info itself is not changed; res[0..num-1] receives the results.
+----------------------------------------------------------------------------*/
+EX_replicate(ga_info, num, num_threads, res)
+   GA_Info_Ptr   ga_info;
+   int           num, num_threads;
+   EX_Result_Ptr res;
+{
+   TH_Pool_Ptr tp;
+   EX_Job_Type job;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("EX_replicate: invalid ga_info");
+   if(num <= 0) return OK;
+   if(res == NULL) UT_error("EX_replicate: null res");
+
+   /*--- How many threads? ---*/
+   if(num_threads <= 0) num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   num_threads = MAX(1, MIN(num_threads, num));
+
+   /*--- Do the runs ---*/
+   job.ga_info = ga_info;
+   job.res     = res;
+   tp = TH_alloc(num_threads);
+   TH_run(tp, EX_item, (void *)&job, num);
+   TH_free(tp);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Run i of EX_replicate()
+----------------------------------------------------------------------------*/
+void EX_item(arg, i, id)
+   void *arg;
+   int  i, id;
+{
+   EX_Job_Ptr  job;
+   GA_Info_Ptr ga_info;
+
+   job = (EX_Job_Ptr)arg;
+
+   /*--- A quiet copy of the configuration with its own seed ---*/
+   ga_info = CF_clone(job->ga_info);
+   ga_info->rand_seed    = job->ga_info->rand_seed + i;
+   ga_info->rp_type      = RP_NONE;
+   ga_info->eval_threads = 1;
+   ga_info->eval_procs   = 0;
+   ga_info->shm_name[0]  = '\0';
+
+   /*--- Run it ---*/
+   GA_run(ga_info);
+
+   /*--- Save results ---*/
+   job->res[i].seed      = ga_info->rand_seed;
+   job->res[i].best      = ga_info->best->fitness;
+   job->res[i].best_iter = ga_info->best_iter;
+   job->res[i].best_time = ga_info->best_time;
+   job->res[i].time      = EX_clock() - ga_info->start_time;
+
+   CF_free(ga_info);
+}
+
+/*----------------------------------------------------------------------------
+| Write results of EX_replicate() as CSV: one line per run, then lines for
+| the best run, the mean and the standard deviation of each column
+----------------------------------------------------------------------------*/
+EX_csv(fid, res, num, minimize)
+   FILE          *fid;
+   EX_Result_Ptr res;
+   int           num, minimize;
+{
+   double sum[4], sum2[4], val[4], dev;
+   int    i, j, b;
+
+   /*--- Error check ---*/
+   if(fid == NULL) UT_error("EX_csv: invalid fid");
+   if(num > 0 && res == NULL) UT_error("EX_csv: null res");
+
+   /*--- One line per run ---*/
+   fprintf(fid, "run,seed,best,iter_to_best,time_to_best,time\n");
+   for(j = 0; j < 4; j++) sum[j] = sum2[j] = 0.0;
+   for(i = 0, b = 0; i < num; i++) {
+      fprintf(fid, "%d,%d,%.10g,%d,%.6f,%.6f\n", i+1, res[i].seed,
+              res[i].best, res[i].best_iter, res[i].best_time, res[i].time);
+
+      /*--- Best run ---*/
+      if(( minimize && res[i].best < res[b].best) ||
+         (!minimize && res[i].best > res[b].best)) b = i;
+
+      /*--- Sums for mean and standard deviation ---*/
+      val[0] = res[i].best;
+      val[1] = res[i].best_iter;
+      val[2] = res[i].best_time;
+      val[3] = res[i].time;
+      for(j = 0; j < 4; j++) {
+         sum[j]  += val[j];
+         sum2[j] += val[j] * val[j];
+      }
+   }
+   if(num <= 0) return OK;
+
+   /*--- Best run ---*/
+   fprintf(fid, "best,%d,%.10g,%d,%.6f,%.6f\n", res[b].seed,
+           res[b].best, res[b].best_iter, res[b].best_time, res[b].time);
+
+   /*--- Mean ---*/
+   fprintf(fid, "mean,,%.10g,%.6g,%.6f,%.6f\n", sum[0] / num,
+           sum[1] / num, sum[2] / num, sum[3] / num);
+
+   /*--- Standard deviation (sample) ---*/
+   fprintf(fid, "std_dev,");
+   for(j = 0; j < 4; j++) {
+      dev = 0.0;
+      if(num > 1) dev = (sum2[j] - sum[j] * sum[j] / num) / (num - 1);
+      fprintf(fid, ",%.10g", dev > 0.0 ? sqrt(dev) : 0.0);
+   }
+   fprintf(fid, "\n");
+   fflush(fid);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Wall clock time in seconds
+----------------------------------------------------------------------------*/
+double EX_clock()
+{
+   struct timeval tv;
+
+   gettimeofday(&tv, NULL);
+   return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+}
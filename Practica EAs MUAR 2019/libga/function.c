@@ -7,15 +7,19 @@
 |    FN_set_fun() - Set user function
 |    FN_select()  - Select function by name
 |    FN_name()    - Get function name from function pointer
+|
+| NOTE: The user defined function of each table is kept in ga_info (the
+|       `user' argument), not in slot 0 of the table, so that every
+|       ga_info can have its own.
 ============================================================================*/
 #include "ga.h"
 
 /*----------------------------------------------------------------------------
 | Set and select user defined function
 ----------------------------------------------------------------------------*/
-FN_set_fun(ga_info, fn_table, fn_name, fn_ptr, rtn_fun)
+FN_set_fun(ga_info, user, fn_name, fn_ptr, rtn_fun)
    GA_Info_Ptr  ga_info;
-   FN_Table_Ptr fn_table;
+   FN_Table_Ptr user;
    char         *fn_name;
    FN_Ptr       fn_ptr, *rtn_fun;
 {
@@ -23,27 +27,28 @@ FN_set_fun(ga_info, fn_table, fn_name, fn_ptr, rtn_fun)
 
    /*--- Check for invalid ga_info ---*/
    if(!CF_valid(ga_info)) UT_error("FN_set_fun: invalid ga_info");
+   if(user == NULL) UT_error("FN_set_fun: invalid user");
    if(rtn_fun == NULL) UT_error("FN_set_fun: invalid rtn_fun");
 
    /*--- Free current function name ---*/
-   if(fn_table[0].name != NULL) {
-      free(fn_table[0].name);
-      fn_table[0].name = NULL;
+   if(user->name != NULL) {
+      free(user->name);
+      user->name = NULL;
    }
 
    /*--- Set function name if provided ---*/
    if(fn_name != NULL && (len = strlen(fn_name) + 1) > 1) {
 
       /*--- Allocate memory for function name ---*/
-      fn_table[0].name = (char *)calloc(len, sizeof(char));
-      if(fn_table[0].name == NULL) UT_error("FN_set_fun: alloc failed");
+      user->name = (char *)calloc(len, sizeof(char));
+      if(user->name == NULL) UT_error("FN_set_fun: alloc failed");
 
       /*--- Copy the function name ---*/
-      strcpy(fn_table[0].name, fn_name);
+      strcpy(user->name, fn_name);
    }
 
    /*--- Set user function ---*/
-   fn_table[0].fun = fn_ptr;
+   user->fun = fn_ptr;
 
    /*--- Set return function ---*/
    *rtn_fun = fn_ptr;
@@ -52,9 +57,9 @@ FN_set_fun(ga_info, fn_table, fn_name, fn_ptr, rtn_fun)
 /*----------------------------------------------------------------------------
 | Select function by name
 ----------------------------------------------------------------------------*/
-void FN_select(ga_info, fn_table, fn_name, rtn_fun)
+void FN_select(ga_info, fn_table, user, fn_name, rtn_fun)
    GA_Info_Ptr  ga_info;
-   FN_Table_Ptr fn_table;
+   FN_Table_Ptr fn_table, user;
    char         *fn_name;
    FN_Ptr       *rtn_fun;
 {
@@ -62,18 +67,19 @@ void FN_select(ga_info, fn_table, fn_name, rtn_fun)
 
    /*--- Check for invalid ga_info ---*/
    if(!CF_valid(ga_info)) UT_error("FN_select: invalid ga_info");
+   if(user == NULL) UT_error("FN_select: invalid user");
    if(rtn_fun == NULL) UT_error("FN_select: invalid rtn_fun");
 
    /*--- User defined crossover? ---*/
-   if(fn_table[0].name != NULL &&
-      !strncmp(fn_name, fn_table[0].name, strlen(fn_table[0].name))) 
+   if(user->name != NULL &&
+      !strncmp(fn_name, user->name, strlen(user->name))) 
    {
       /*--- Null user function ---*/
-      if(fn_table[0].fun == NULL) 
+      if(user->fun == NULL) 
          UT_warn("FN_select: User function is NULL");
 
       /*--- Return pointer to user function ---*/
-      *rtn_fun = fn_table[0].fun; 
+      *rtn_fun = user->fun; 
       return; 
    }
 
@@ -98,18 +104,27 @@ void FN_select(ga_info, fn_table, fn_name, rtn_fun)
 /*----------------------------------------------------------------------------
 | Function name
 ----------------------------------------------------------------------------*/
-char *FN_name(ga_info, fn_table, fn_ptr)
+char *FN_name(ga_info, fn_table, user, fn_ptr)
    GA_Info_Ptr  ga_info;
-   FN_Table_Ptr fn_table;
+   FN_Table_Ptr fn_table, user;
    FN_Ptr       fn_ptr;
 {
    int i;
 
    /*--- Check for invalid ga_info ---*/
    if(!CF_valid(ga_info)) UT_error("FN_name: invalid ga_info");
+   if(user == NULL) UT_error("FN_name: invalid user");
+
+   /*--- User defined function? ---*/
+   if(fn_ptr == user->fun) {
+      if(user->name == NULL) 
+         return "Unspecified";
+      else
+         return user->name;
+   }
 
    /*--- Search for current function in fn_table ---*/
-   for(i = 0; i == 0 || fn_table[i].fun != NULL; i++) {
+   for(i = 1; fn_table[i].fun != NULL; i++) {
 
       /*--- Does this function match? ---*/
       if(fn_ptr == fn_table[i].fun) {
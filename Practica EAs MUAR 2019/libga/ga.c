@@ -6,9 +6,15 @@
 | Operators
 |    GA_generational()  - generational GA
 |       GA_gen_init()   - initialize generational GA
+|       GA_gen_step()   - one generation
 |       GA_init_trial() - initialize inner loop for generational GA
+|       GA_end_trial()  - finish inner loop for generational GA
 |    GA_steady_state()  - steady state GA
 |       GA_ss_init()    - initialize steady state GA
+|       GA_ss_step()    - one trial
+|    GA_islands()       - island model GA (see island.c)
+|    GA_ss_async()      - asynchronous steady state GA (see async.c)
+|    GA_cellular()      - cellular GA (see cellular.c)
 |    
 | Interface
 |    GA_table[]   - used in selection of GA method
@@ -22,14 +28,16 @@
 |    
 | Utility
 |    GA_trial()      - a single iteration of the inner loop
+|    GA_batch()      - all trials of a generation at once
+|    GA_ss_batch()   - batch children of a steady state GA at once
 |    GA_cum()        - see if children are the cumulative/historical best
 |    GA_gap()        - handle generation gap
+|    GA_done()       - free work space of GA_gen_init()/GA_ss_init()
 ============================================================================*/
 #include "ga.h"
 
-int GA_generational(), GA_steady_state();
-
-static Chrom_Ptr child1, child2;
+int GA_generational(), GA_steady_state(), GA_islands(), GA_ss_async();
+int GA_cellular();
 
 /*============================================================================
 |                                  Interface
@@ -38,10 +46,13 @@ static Chrom_Ptr child1, child2;
 | GA table
 ----------------------------------------------------------------------------*/
 FN_Table_Type GA_table[] = {
-   { NULL,           NULL            },  /* user defined function */
-   { "generational", GA_generational },
-   { "steady_state", GA_steady_state },
-   { NULL,           NULL            }
+   { NULL,                 NULL            },  /* user defined function */
+   { "generational",       GA_generational },
+   { "steady_state",       GA_steady_state },
+   { "islands",            GA_islands      },
+   { "async_steady_state", GA_ss_async     },
+   { "cellular",           GA_cellular     },
+   { NULL,                 NULL            }
 };
 
 /*----------------------------------------------------------------------------
@@ -52,7 +63,8 @@ GA_set_fun(ga_info, fn_name, fn_ptr)
    char         *fn_name;
    FN_Ptr       fn_ptr;
 {
-   return FN_set_fun(ga_info, GA_table, fn_name, fn_ptr, &ga_info->GA_fun);
+   return FN_set_fun(ga_info, &ga_info->GA_user, fn_name, fn_ptr, 
+                     &ga_info->GA_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -62,7 +74,8 @@ GA_select(ga_info, fn_name)
    GA_Info_Ptr  ga_info;
    char         *fn_name;
 {
-   return FN_select(ga_info, GA_table, fn_name, &ga_info->GA_fun);
+   return FN_select(ga_info, GA_table, &ga_info->GA_user, fn_name, 
+                    &ga_info->GA_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -71,7 +84,7 @@ GA_select(ga_info, fn_name)
 char *GA_name(ga_info)
    GA_Info_Ptr  ga_info;
 {
-   return FN_name(ga_info, GA_table, ga_info->GA_fun);
+   return FN_name(ga_info, GA_table, &ga_info->GA_user, ga_info->GA_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -136,10 +149,34 @@ GA_run(ga_info)
    RP_config(ga_info);
 
    /*--- Seed random number generator ---*/
-   SEED_RAND(ga_info->rand_seed);
+   RN_seed(&ga_info->rn, ga_info->rand_seed);
+
+   /*--- Start evaluation processes or threads (not for islands) ---*/
+   if(ga_info->eval_procs > 0 && ga_info->GA_fun != GA_islands)
+      ga_info->pr_pool = PR_alloc(ga_info->eval_procs, ga_info->eval_cmd,
+                                  ga_info->EV_fun);
+   else if(ga_info->eval_threads > 1 && ga_info->GA_fun != GA_islands &&
+           ga_info->GA_fun != GA_ss_async)
+      ga_info->th_pool = TH_alloc(ga_info->eval_threads);
+
+   /*--- Monitor the pool in shared memory (not for islands) ---*/
+   if(ga_info->shm_name[0] != '\0' && ga_info->GA_fun != GA_islands)
+      ga_info->sm = SM_create(ga_info->shm_name, ga_info->pool_size + 2,
+                              ga_info->chrom_len);
 
    /*--- Run the GA ---*/
+   ga_info->start_time = EX_clock();
    ga_info->GA_fun(ga_info);
+
+   /*--- Remove the shared memory ---*/
+   SM_free(ga_info->sm);
+   ga_info->sm = NULL;
+
+   /*--- Stop evaluation threads and processes ---*/
+   TH_free(ga_info->th_pool);
+   ga_info->th_pool = NULL;
+   PR_free(ga_info->pr_pool);
+   ga_info->pr_pool = NULL;
 }
 
 /*============================================================================
@@ -151,8 +188,6 @@ GA_run(ga_info)
 GA_generational(ga_info)
    GA_Info_Ptr ga_info;
 {
-   Pool_Ptr      tmp_pool;
- 
    /*--- Initialize ---*/
    GA_gen_init(ga_info);
 
@@ -164,32 +199,15 @@ GA_generational(ga_info)
       /*--- Check for convergence ---*/
       if(ga_info->use_convergence && ga_info->converged) break;
 
-      /*--- Setup for new set of trials ---*/
-      GA_init_trial(ga_info);
-
-      /*--- Handle generation gap ---*/
-      GA_gap(ga_info);
-
-      /*--- Inner loop is for each reproduction ---*/
-      for( ; ga_info->new_pool->size < ga_info->old_pool->size; ) {
-         GA_trial(ga_info);
-      }
-
-      /*--- Print report if appropriate ---*/
-      RP_report(ga_info, ga_info->new_pool);
-
-      /*--- Swap old and new pools ---*/
-      tmp_pool          = ga_info->old_pool;
-      ga_info->old_pool = ga_info->new_pool;
-      ga_info->new_pool = tmp_pool;
+      /*--- One generation ---*/
+      GA_gen_step(ga_info);
    }
 
    /*--- Final report ---*/
    RP_final(ga_info);
 
-   /*--- Free genes for children ---*/
-   CH_free(child1);
-   CH_free(child2);
+   /*--- Free work space ---*/
+   GA_done(ga_info);
 
    return OK;
 }
@@ -205,6 +223,10 @@ GA_gen_init(ga_info)
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("GA_generational: invalid ga_info");
 
+   /*--- Children are appended to the new pool (kids only exist for it) ---*/
+   if(strcmp(RE_name(ga_info), "append"))
+      UT_error("GA_gen_init: replacement invalid under generational model");
+
    /*--- Make sure pool allocation is ok ---*/
    if(!PL_valid(ga_info->old_pool))
       ga_info->old_pool = PL_alloc(ga_info->pool_size);
@@ -213,6 +235,10 @@ GA_gen_init(ga_info)
    old_pool = ga_info->old_pool;
    new_pool = ga_info->new_pool;
 
+   /*--- Chromosomes of each pool in one block, genes shared (elites) ---*/
+   if(ga_info->chrom_len > 0)
+      PL_arena_pair(old_pool, new_pool, ga_info->chrom_len, CH_store(ga_info));
+
    /*--- Minimize or maximize? ---*/
    old_pool->minimize = new_pool->minimize = ga_info->minimize;
  
@@ -241,30 +267,99 @@ GA_gen_init(ga_info)
       CH_copy(old_pool->chrom[old_pool->min_index], ga_info->best);
    else
       CH_copy(old_pool->chrom[old_pool->max_index], ga_info->best);
+   ga_info->best_iter = 0;
+   ga_info->best_time = EX_clock() - ga_info->start_time;
  
    /*--- No mutations yet ---*/
    ga_info->num_mut = 0;
    ga_info->tot_mut = 0;
+
+   /*--- Pool has not been ranked yet ---*/
+   ga_info->ranked = FALSE;
  
    /*--- Initial pool report ---*/
    ga_info->iter = -1;
    RP_report(ga_info, old_pool);
 
    /*--- Allocate genes for children ---*/
-   child1 = CH_alloc(ga_info->chrom_len);
-   child2 = CH_alloc(ga_info->chrom_len);
+   ga_info->child1 = CH_alloc(ga_info->chrom_len);
+   ga_info->child2 = CH_alloc(ga_info->chrom_len);
+
+   /*--- Room for a whole generation of children (parallel evaluation) ---*/
+   if(TH_valid(ga_info->th_pool) || PR_valid(ga_info->pr_pool) ||
+      ga_info->par_repro) {
+      ga_info->kids  = PL_alloc(old_pool->size + 2);
+      if(strcmp(RE_name(ga_info), "append"))   /* Else bred in new_pool */
+         PL_arena(ga_info->kids, ga_info->chrom_len, CH_store(ga_info));
+   }
+
+   /*--- Room for the parents of a whole generation ---*/
+   ga_info->mates = (Chrom_Ptr *)calloc(old_pool->size + 2, sizeof(Chrom_Ptr));
+   if(ga_info->mates == NULL) UT_error("GA_gen_init: mates alloc failed");
 }
  
+/*----------------------------------------------------------------------------
+| One generation, i.e., iteration ga_info->iter (Generational GA only)
+----------------------------------------------------------------------------*/
+GA_gen_step(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   Pool_Ptr tmp_pool;
+
+   /*--- Setup for new set of trials ---*/
+   GA_init_trial(ga_info);
+
+   /*--- The old pool is only read from now on: prepare selection once ---*/
+   SE_prepare(ga_info, ga_info->old_pool);
+   ga_info->se_ready = TRUE;
+
+   /*--- Handle generation gap ---*/
+   GA_gap(ga_info);
+
+   /*--- Inner loop is for each reproduction (all parents at once) ---*/
+   if(ga_info->par_repro)
+      BR_generation(ga_info);
+   else
+      GA_batch(ga_info);
+   ga_info->se_ready = FALSE;
+
+   /*--- Wrap up the new pool ---*/
+   GA_end_trial(ga_info);
+
+   /*--- Print report if appropriate ---*/
+   RP_report(ga_info, ga_info->new_pool);
+
+   /*--- Swap old and new pools ---*/
+   tmp_pool          = ga_info->old_pool;
+   ga_info->old_pool = ga_info->new_pool;
+   ga_info->new_pool = tmp_pool;
+
+   /*--- Pool monitor in shared memory ---*/
+   SM_sync(ga_info, ga_info->old_pool);
+
+   return OK;
+}
+
 /*----------------------------------------------------------------------------
 | Setup for a new set of trials (Generational GA only)
+|
+| NOTE: when children are appended, the two elites only get their slots
+|       now; the elite itself moves in at the end of the generation (see
+|       GA_end_trial()), when the old pool is no longer needed, instead of
+|       being copied twice right away.
 ----------------------------------------------------------------------------*/
 GA_init_trial(ga_info)
    GA_Info_Ptr  ga_info;
 {
+   Pool_Ptr  old_pool, new_pool;
+   Chrom_Ptr elite;
 
+   old_pool = ga_info->old_pool;
+   new_pool = ga_info->new_pool;
 
    /*--- Cleanup the new pool ---*/
-   ga_info->new_pool->size = 0;
+   new_pool->size = 0;
+   ga_info->elite = NULL;
  
    /*--- Reset number of mutations ---*/
    ga_info->num_mut = 0;
@@ -272,23 +367,49 @@ GA_init_trial(ga_info)
    /*--- Not elitist ---*/
    if(!ga_info->elitist) return OK;
  
-   /*--- Save best members if Elitist ---*/
-   if(ga_info->minimize) {
-      PL_append(ga_info->new_pool,
-                ga_info->old_pool->chrom[ga_info->old_pool->min_index],
-                TRUE);
-      PL_append(ga_info->new_pool,
-                ga_info->old_pool->chrom[ga_info->old_pool->min_index],
-                TRUE);
+   /*--- Best member ---*/
+   if(ga_info->minimize)
+      elite = old_pool->chrom[old_pool->min_index];
+   else
+      elite = old_pool->chrom[old_pool->max_index];
+
+   /*--- Save it twice if Elitist (appending: later) ---*/
+   if(!strcmp(RE_name(ga_info), "append")) {
+      PL_slot(new_pool, 0, elite->length);
+      PL_slot(new_pool, 1, elite->length);
+      new_pool->size = 2;
+      ga_info->elite = elite;
    } else {
-      PL_append(ga_info->new_pool,
-                ga_info->old_pool->chrom[ga_info->old_pool->max_index],
-                TRUE);
-      PL_append(ga_info->new_pool,
-                ga_info->old_pool->chrom[ga_info->old_pool->max_index],
-                TRUE);
+      PL_append(new_pool, elite, TRUE);
+      PL_append(new_pool, elite, TRUE);
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Finish a set of trials (Generational GA only): the elite saved by
+| GA_init_trial() takes over the first slot of the new pool, genes and all
+| (see PL_take()), and the second slot gets a copy of it.  The stats of the
+| new pool are only worked out here, once it is full.
+----------------------------------------------------------------------------*/
+GA_end_trial(ga_info)
+   GA_Info_Ptr  ga_info;
+{
+   Pool_Ptr new_pool;
+
+   new_pool = ga_info->new_pool;
+
+   /*--- Move the elite in, then copy ---*/
+   if(ga_info->elite != NULL) {
+      PL_take(new_pool, 0, ga_info->old_pool, ga_info->elite);
+      PL_insert(new_pool, 1, new_pool->chrom[0], TRUE);
+      ga_info->elite = NULL;
    }
 
+   /*--- Make sure stats are updated ---*/
+   PL_stats(ga_info, new_pool);
+
    return OK;
 }
 
@@ -313,22 +434,44 @@ GA_steady_state(ga_info)
       if(ga_info->use_convergence && ga_info->converged) break;
  
       /*--- "Inner loop" is a single reproduction ---*/
-      GA_trial(ga_info);
- 
-      /*--- Print report if appropriate ---*/
-      RP_report(ga_info, ga_info->new_pool);
+      GA_ss_step(ga_info);
    }
  
    /*--- Final report ---*/
    RP_final(ga_info);
 
-   /*--- Free genes for children ---*/
-   CH_free(child1);
-   CH_free(child2);
+   /*--- Free work space ---*/
+   GA_done(ga_info);
  
    return OK;
 }
 
+/*----------------------------------------------------------------------------
+| One trial, i.e., iteration ga_info->iter (Steady state GA only)
+----------------------------------------------------------------------------*/
+GA_ss_step(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   /*--- Parents are all selected before any replacement: prepare once ---*/
+   SE_prepare(ga_info, ga_info->old_pool);
+   ga_info->se_ready = TRUE;
+
+   /*--- A single reproduction, or a batch of them ---*/
+   if(ga_info->batch > 2)
+      GA_ss_batch(ga_info);
+   else
+      GA_trial(ga_info);
+   ga_info->se_ready = FALSE;
+ 
+   /*--- Print report if appropriate ---*/
+   RP_report(ga_info, ga_info->new_pool);
+
+   /*--- Pool monitor in shared memory ---*/
+   SM_sync(ga_info, ga_info->new_pool);
+
+   return OK;
+}
+
 /*----------------------------------------------------------------------------
 | Initialize GA
 ----------------------------------------------------------------------------*/
@@ -353,6 +496,10 @@ GA_ss_init(ga_info)
    }
    pool = ga_info->old_pool;
 
+   /*--- Chromosomes of the pool in one block ---*/
+   if(ga_info->chrom_len > 0)
+      PL_arena(pool, ga_info->chrom_len, CH_store(ga_info));
+
    /*--- Minimize or maximize ---*/
    pool->minimize = ga_info->minimize;
 
@@ -371,18 +518,29 @@ GA_ss_init(ga_info)
       CH_copy(pool->chrom[pool->min_index], ga_info->best);
    else
       CH_copy(pool->chrom[pool->max_index], ga_info->best);
+   ga_info->best_iter = 0;
+   ga_info->best_time = EX_clock() - ga_info->start_time;
 
    /*--- No mutations yet ---*/
    ga_info->num_mut = 0;
    ga_info->tot_mut = 0;
 
+   /*--- Pool has not been ranked yet ---*/
+   ga_info->ranked = FALSE;
+
    /*--- Initial pool report ---*/
    ga_info->iter = -1;
    RP_report(ga_info, pool);
 
    /*--- Allocate genes for children ---*/
-   child1 = CH_alloc(ga_info->chrom_len);
-   child2 = CH_alloc(ga_info->chrom_len);
+   ga_info->child1 = CH_alloc(ga_info->chrom_len);
+   ga_info->child2 = CH_alloc(ga_info->chrom_len);
+
+   /*--- Children of a batch, then copies of their parents ---*/
+   if(ga_info->batch > 2) {
+      ga_info->kids = PL_alloc(2 * ga_info->batch);
+      PL_arena(ga_info->kids, ga_info->chrom_len, CH_store(ga_info));
+   }
 }
 
 /*============================================================================
@@ -394,8 +552,18 @@ GA_ss_init(ga_info)
 GA_trial(ga_info)
    GA_Info_Ptr ga_info;
 {
-   Chrom_Ptr parent1, parent2;
-
+   Chrom_Ptr parent1, parent2, child1, child2;
+   Pool_Ptr  pool;
+
+   /*--- Appending: children are bred right in their slots ---*/
+   if(!strcmp(RE_name(ga_info), "append")) {
+      pool   = ga_info->new_pool;
+      child1 = PL_slot(pool, pool->size,     ga_info->chrom_len);
+      child2 = PL_slot(pool, pool->size + 1, ga_info->chrom_len);
+   } else {
+      child1 = ga_info->child1;
+      child2 = ga_info->child2;
+   }
 
    /*--- Selection ---*/
    parent1 = SE_fun(ga_info, ga_info->old_pool);
@@ -413,8 +581,7 @@ GA_trial(ga_info)
    MU_fun(ga_info, child2);
    
    /*--- Evaluate children ---*/
-   ga_info->EV_fun(child1);
-   ga_info->EV_fun(child2);
+   EV_pair(ga_info, child1, child2);
 
    /*--- Validate children ---*/
    CH_verify(ga_info, child1);
@@ -426,30 +593,171 @@ GA_trial(ga_info)
    /*--- Best So Far? ---*/
    GA_cum(ga_info, child1, child2);
    
-   /*--- Update GA system statistics ---*/
-   PL_stats(ga_info, ga_info->new_pool);
+   /*--- Update GA system statistics (two slots changed at most) ---*/
+   PL_restat(ga_info, ga_info->new_pool);
+}
+
+/*----------------------------------------------------------------------------
+| All remaining trials of a generation (Generational GA only)
+|
+| The parents are all selected first by SE_batch(), then all of the
+| children are bred, evaluated at once by EV_batch() and put into the new
+| pool in breeding order.  The result does not depend on the number of
+| evaluation threads.  The stats of the new pool are left to GA_end_trial().
+----------------------------------------------------------------------------*/
+GA_batch(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   Pool_Ptr  new_pool, kids;
+   Chrom_Ptr *kid, *mate;
+   int       i, num;
+
+   /*--- Number of children still needed (whole pairs) ---*/
+   new_pool = ga_info->new_pool;
+   num = ga_info->old_pool->size - new_pool->size;
+   if(num <= 0) return OK;
+   num += num % 2;
+   mate = ga_info->mates;
+
+   /*--- Where do the children go? (appending: right in their slots) ---*/
+   if(!strcmp(RE_name(ga_info), "append")) {
+      kids = new_pool;
+      PL_slot(kids, new_pool->size + num - 1, ga_info->chrom_len);
+      kid = kids->chrom + new_pool->size;
+   } else {
+      kids = ga_info->kids;
+      if(num > kids->max_size) UT_error("GA_batch: too many kids");
+      kid = kids->chrom;
+   }
+
+   /*--- Parents of every pair ---*/
+   SE_batch(ga_info, ga_info->old_pool, mate, num);
+
+   /*--- Breed every pair ---*/
+   for(i = 0; i < num; i += 2) {
+
+      /*--- Make sure children are allocated ---*/
+      if(!CH_valid(kid[i]))
+         kid[i]   = PL_new_chrom(kids, ga_info->chrom_len);
+      if(!CH_valid(kid[i+1]))
+         kid[i+1] = PL_new_chrom(kids, ga_info->chrom_len);
+
+      /*--- Validate parents ---*/
+      CH_verify(ga_info, mate[i]);
+      CH_verify(ga_info, mate[i+1]);
+
+      /*--- Crossover ---*/
+      X_fun(ga_info, mate[i], mate[i+1], kid[i], kid[i+1]);
+
+      /*--- Mutation ---*/
+      MU_fun(ga_info, kid[i]);
+      MU_fun(ga_info, kid[i+1]);
+   }
+
+   /*--- Evaluate all children ---*/
+   EV_batch(ga_info, kid, num);
+
+   /*--- Replacement, in breeding order ---*/
+   for(i = 0; i < num; i += 2) {
+
+      /*--- Validate children ---*/
+      CH_verify(ga_info, kid[i]);
+      CH_verify(ga_info, kid[i+1]);
+
+      /*--- Replacement ---*/
+      RE_fun(ga_info, new_pool, mate[i], mate[i+1], kid[i], kid[i+1]);
+
+      /*--- Best So Far? ---*/
+      GA_cum(ga_info, kid[i], kid[i+1]);
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| batch children at once (Steady state GA only)
+|
+| All parents are selected from the pool as it is, the children are
+| evaluated at once by EV_batch() and then put into the pool a pair at a
+| time, in breeding order.  Parents are copied first, since an earlier pair
+| may replace them.  Statistics are updated once per batch.
+----------------------------------------------------------------------------*/
+GA_ss_batch(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   Chrom_Ptr *kid, *mate, parent1, parent2;
+   int       i, num;
+
+   num  = ga_info->batch;
+   kid  = ga_info->kids->chrom;
+   mate = ga_info->kids->chrom + num;
+
+   /*--- Breed every pair ---*/
+   for(i = 0; i < num; i += 2) {
+
+      /*--- Selection ---*/
+      parent1 = SE_fun(ga_info, ga_info->old_pool);
+      parent2 = SE_fun(ga_info, ga_info->old_pool);
+
+      /*--- Validate parents ---*/
+      CH_verify(ga_info, parent1);
+      CH_verify(ga_info, parent2);
+      CH_copy(parent1, mate[i]);
+      CH_copy(parent2, mate[i+1]);
+
+      /*--- Crossover ---*/
+      X_fun(ga_info, parent1, parent2, kid[i], kid[i+1]);
+
+      /*--- Mutation ---*/
+      MU_fun(ga_info, kid[i]);
+      MU_fun(ga_info, kid[i+1]);
+   }
+
+   /*--- Evaluate all children ---*/
+   EV_batch(ga_info, kid, num);
+
+   /*--- Replacement, in breeding order ---*/
+   for(i = 0; i < num; i += 2) {
+
+      /*--- Validate children ---*/
+      CH_verify(ga_info, kid[i]);
+      CH_verify(ga_info, kid[i+1]);
+
+      /*--- Replacement ---*/
+      RE_fun(ga_info, ga_info->new_pool, mate[i], mate[i+1], kid[i], kid[i+1]);
+
+      /*--- Best So Far? ---*/
+      GA_cum(ga_info, kid[i], kid[i+1]);
+   }
+
+   /*--- Update GA system statistics (only the changed slots) ---*/
+   PL_restat(ga_info, ga_info->new_pool);
+
+   return OK;
 }
 
 /*============================================================================
 |                               Utility
 ============================================================================*/
 /*----------------------------------------------------------------------------
-| See if children are best so far
+| See if children are best so far (the better child is copied, if any)
 ----------------------------------------------------------------------------*/
 GA_cum(ga_info, c1, c2)
    GA_Info_Ptr ga_info;
    Chrom_Ptr   c1, c2;
 {
-   if(ga_info->minimize) {
-      if(c1->fitness < ga_info->best->fitness)
-         CH_copy(c1, ga_info->best);
-      if(c2->fitness < ga_info->best->fitness)
-         CH_copy(c2, ga_info->best);
-   } else {
-      if(c1->fitness > ga_info->best->fitness)
-         CH_copy(c1, ga_info->best);
-      if(c2->fitness > ga_info->best->fitness)
-         CH_copy(c2, ga_info->best);
+   Chrom_Ptr better;
+
+   /*--- Better child (c1 on ties) ---*/
+   better = CH_cmp(ga_info, c2, c1) < 0 ? c2 : c1;
+
+   /*--- Better than best so far? ---*/
+   if(CH_cmp(ga_info, better, ga_info->best) < 0) {
+      CH_copy(better, ga_info->best);
+
+      /*--- Remember when (time-to-best) ---*/
+      ga_info->best_iter = ga_info->iter + 1;
+      ga_info->best_time = EX_clock() - ga_info->start_time;
    }
 }
 
@@ -487,3 +795,28 @@ GA_gap(ga_info)
 
    return OK;
 }
+
+/*----------------------------------------------------------------------------
+| Free the work space allocated by GA_gen_init() or GA_ss_init()
+----------------------------------------------------------------------------*/
+GA_done(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   /*--- Free genes for children ---*/
+   CH_free(ga_info->child1);
+   CH_free(ga_info->child2);
+   ga_info->child1 = ga_info->child2 = NULL;
+
+   /*--- Free children of parallel generations, and parents ---*/
+   if(ga_info->kids != NULL) {
+      PL_free(ga_info->kids);
+      ga_info->kids = NULL;
+   }
+   free(ga_info->mates);
+   ga_info->mates = NULL;
+
+   /*--- Free breeders of parallel reproduction ---*/
+   BR_free(ga_info);
+
+   return OK;
+}
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <math.h>
 #include <ctype.h>
+#include <pthread.h>
+#include <sys/types.h>
 
 #if defined(__BORLANDC__)
 #include <process.h>
@@ -46,6 +48,13 @@
 #define DT_INT_PERM  2   /* Integer Permutation */
 #define DT_REAL      3   /* Reals */
 
+/*--- Gene storage --- */
+#define ST_DOUBLE    0   /* A Gene_Type per gene */
+#define ST_BITS      1   /* Bits packed in CH_Words (DT_BIT) */
+#define ST_INT16     2   /* A short per gene (DT_INT, DT_INT_PERM) */
+#define ST_INT32     3   /* An int per gene (DT_INT, DT_INT_PERM) */
+#define ST_FLOAT     4   /* A float per gene (DT_REAL) */
+
 /*--- Method to generate initial pool --- */
 #define IP_NONE         0x00
 #define IP_INTERACTIVE  0x01
@@ -59,11 +68,32 @@
 #define RP_SHORT   2
 #define RP_LONG    3
 
+/*--- Island model: migration topology and who is replaced --- */
+#define MG_RING    0   /* Island i sends to island i+1 */
+#define MG_TORUS   1   /* Islands on a 2D torus, send to 4 neighbors */
+#define MG_FULL    2   /* Every island sends to every other one */
+#define MG_WORST   0   /* Migrants replace the worst chromosomes */
+#define MG_RANDOM  1   /* Migrants replace random ones (never the best) */
+
+/*--- Island model: role of this process (see net.c) --- */
+#define NT_NONE        0   /* All islands here, one thread each */
+#define NT_COORDINATOR 1   /* Coordinator of islands in other processes */
+#define NT_ISLAND      2   /* One island, talking to the coordinator */
+
+/*--- Cellular GA: neighborhood and order of update --- */
+#define CE_VON_NEUMANN 0   /* North, south, east and west */
+#define CE_MOORE       1   /* Also the diagonals */
+#define CE_SYNC        0   /* All cells at once */
+#define CE_SWEEP       1   /* One cell after the other (line sweep) */
+
 /*--- Magic cookies for validation ---*/
 #define NL_cookie 0x00000000   /* NULL cookie */
 #define CF_cookie 0x11111111   /* ga_info (config) cookie */
 #define PL_cookie 0x22222222   /* pool cookie */
 #define CH_cookie 0x33333333   /* chrom cookie */
+#define TH_cookie 0x44444444   /* thread pool cookie */
+#define PR_cookie 0x55555555   /* process pool cookie */
+#define SM_cookie 0x66666666   /* shared memory pool monitor cookie */
 
 /*----------------------------------------------------------------------------
 | Type definitions 
@@ -80,10 +110,24 @@ typedef struct {
 /*--- A Gene (or allele) is a bit, int, float, etc. ---*/
 typedef double Gene_Type, *Gene_Ptr;
 
+/*--- Packed bit genes: gene i is bit i%64 of word[i/64] ---*/
+typedef unsigned long long CH_Word;
+#define CH_WORD_BITS  64
+#define CH_WORDS(n)   (((n) + CH_WORD_BITS - 1) / CH_WORD_BITS)
+#define CH_BIT(c,i)   ((int)(((c)->word[(i) / CH_WORD_BITS] >> \
+                              ((i) % CH_WORD_BITS)) & 1))
+
 /*--- A Chromosome ---*/
 typedef struct {
    long       magic_cookie;         /* For validation */
-   Gene_Ptr   gene;                 /* Encoding */
+   union {
+      Gene_Ptr gene;                /* Encoding (ST_DOUBLE) */
+      CH_Word  *word;               /* Encoding (ST_BITS) */
+      short    *i16;                /* Encoding (ST_INT16) */
+      int      *i32;                /* Encoding (ST_INT32) */
+      float    *f32;                /* Encoding (ST_FLOAT) */
+   };
+   int        store;                /* Gene storage (ST_...) */
    int        length;               /* Length of gene */
    double     fitness;              /* Fitness value of chromosome */
    float      ptf;                  /* Percent of total fitness */
@@ -91,8 +135,59 @@ typedef struct {
    int        idx_min, idx_max;     /* Reserved */
    int        parent_1, parent_2;   /* Indices of parents */
    int        xp1, xp2;             /* Crossover points */
+   int        arena;                /* Bytes for genes in a pool arena */
 } Chrom_Type, *Chrom_Ptr;
 
+/*--- Integer genes, whatever the storage (not ST_BITS or ST_FLOAT) ---*/
+#define CH_INT(c,i) \
+   ((c)->store == ST_INT16 ? (int)(c)->i16[i] : \
+    (c)->store == ST_INT32 ? (c)->i32[i] : (int)(c)->gene[i])
+#define CH_SET_INT(c,i,v) \
+   ((c)->store == ST_INT16 ? (void)((c)->i16[i] = (short)(v)) : \
+    (c)->store == ST_INT32 ? (void)((c)->i32[i] = (int)(v)) : \
+                             (void)((c)->gene[i] = (Gene_Type)(v)))
+
+/*--- Real genes, whatever the storage (ST_DOUBLE or ST_FLOAT) ---*/
+#define CH_REAL(c,i) \
+   ((c)->store == ST_FLOAT ? (double)(c)->f32[i] : (c)->gene[i])
+#define CH_SET_REAL(c,i,v) \
+   ((c)->store == ST_FLOAT ? (void)((c)->f32[i] = (float)(v)) : \
+                             (void)((c)->gene[i] = (Gene_Type)(v)))
+
+/*--- Gene j of s to gene i of d, both stored alike (not ST_BITS) ---*/
+#define CH_MOVE(d,i,s,j) \
+   ((d)->store == ST_INT16 ? (void)((d)->i16[i] = (s)->i16[j]) : \
+    (d)->store == ST_INT32 ? (void)((d)->i32[i] = (s)->i32[j]) : \
+    (d)->store == ST_FLOAT ? (void)((d)->f32[i] = (s)->f32[j]) : \
+                             (void)((d)->gene[i] = (s)->gene[j]))
+
+/*--- Sort key of a chromosome of a pool (see PL_sort()) ---*/
+typedef struct {
+   double     fitness;                     /* Its fitness */
+   int        index;                       /* Its slot */
+} Sort_Key_Type, *Sort_Key_Ptr;
+
+/*--- Slot of the roulette wheel of a pool (see PL_update_ptf()) ---*/
+typedef struct {
+   double     cut;                         /* Keep the slot below this */
+   int        alias;                       /* Else take this one */
+} Wheel_Type, *Wheel_Ptr;
+
+/*--- A slot of a pool changed since the last statistics (see PL_restat()) ---*/
+typedef struct {
+   int        index;                       /* The slot */
+   double     was, now;                    /* Its fitness before and after */
+} Change_Type, *Change_Ptr;
+
+/*--- Chrom i of a pool was written in place: its fitness into fit[] ---*/
+#define PL_FIT(p,i) \
+   ((p)->chrom[i]->index = (i), (p)->fit[i] = (p)->chrom[i]->fitness)
+
+/*--- Roulette slice of chrom i of a pool, after PL_update_ptf() ---*/
+#define PL_SLICE(g,p,i) \
+   ((g)->minimize ? 1.0 / ((p)->fit[i] + (g)->scale_factor) : \
+                    (p)->fit[i] + (g)->scale_factor)
+
 /*--- A Pool ---*/
 typedef struct {
    long       magic_cookie;                /* For validation */
@@ -104,15 +199,80 @@ typedef struct {
    int        best_index;                  /* Index of best chromosome */
    int        minimize;                    /* Minimize pool [y/n]? */
    int        sorted;                      /* Is pool sorted [y/n]? */
+   Chrom_Ptr  arena;                       /* Chromosomes allocated at once */
+   Gene_Ptr   arena_gene;                  /* Their genes, a row each */
+   int        *arena_refs;                 /* Pools sharing arena_gene */
+   Chrom_Ptr  *spare;                      /* Removed chroms, for reuse */
+   int        num_spare, max_spare;        /* Number of spare chroms */
+   long       num_alloc;                   /* Allocations made so far */
+   double     *fit;                        /* Fitness of each slot, in a row */
+   float      *ptf;                        /* Ptf of each chrom, in a row */
+   Wheel_Ptr  wheel;                       /* Alias table of the roulette */
+   Sort_Key_Ptr key;                       /* Work space for PL_sort() */
+   int        max_fit;                     /* Room in ptf, wheel and key */
+   Change_Ptr changed;                     /* Slots changed since last stats */
+   int        num_changed, max_changed;    /* (more than max_changed: many) */
+   int        *tree;                       /* Min and max slots (PL_restat()) */
+   int        tree_size;                   /* Leaves of the tree */
+   int        stat_size;                   /* Size at last stats (-1: unknown) */
+   int        num_restat;                  /* Changes since the full stats */
+   double     mean, m2;                    /* Running mean and squared devs */
 } Pool_Type, *Pool_Ptr;
 
-/*--- GA configuration info ---*/
+/*--- A Thread Pool ---*/
+typedef struct {
+   long            magic_cookie;       /* For validation */
+   int             num_threads;        /* Number of threads (incl. caller) */
+   int             num_started;        /* Number of workers started */
+   pthread_t       *tid;               /* Worker threads */
+   pthread_mutex_t lock;               /* Protects everything below */
+   pthread_cond_t  work_cv, done_cv;   /* New job / job finished */
+   int             job_id;             /* Current job number */
+   int             quit;               /* Workers should exit */
+   void            (*fun)();           /* Current job: fun(arg, item, id) */
+   void            *arg;               /* Current job argument */
+   int             num_items;          /* Number of items in job */
+   int             next_item, chunk;   /* Next item to hand out, how many */
+   int             num_busy;           /* Workers still on current job */
+} TH_Pool_Type, *TH_Pool_Ptr;
+
+/*--- A Pool of evaluation processes ---*/
+typedef struct {
+   long     magic_cookie;   /* For validation */
+   int      num_procs;      /* Number of processes */
+   pid_t    *pid;           /* Process ids */
+   int      *to, *from;     /* Pipes to/from each process */
+   Gene_Ptr *buf;           /* Request/reply buffer of each process */
+   int      *buf_len;       /* Size of each buffer (genes) */
+} PR_Pool_Type, *PR_Pool_Ptr;
+
+/*--- Read-only monitor of a pool, in shared memory (see shm.c) ---*/
+typedef struct {
+   long      magic_cookie;   /* For validation */
+   char      name[80];       /* Name of segment ("/name") */
+   int       owner;          /* Created by us (the GA)? */
+   size_t    size;           /* Bytes mapped */
+   char      *base;          /* Where */
+} SM_Type, *SM_Ptr;
+
+/*--- Random number generator state (xoshiro256**) ---*/
+typedef unsigned long long RN_Word;   /* At least 64 bits */
 typedef struct {
+   RN_Word  s[4];       /* Generator state */
+   RN_Word  bits;       /* Unused random bits for RN_bit() */
+   int      num_bits;   /* Number of unused bits */
+} RN_Type, *RN_Ptr;
+
+/*--- GA configuration info ---*/
+typedef struct GA_Info_Struct {
    /*--- Basic info ---*/
    long  magic_cookie;     /* For validation */
    char  user_data[80];    /* User data file (unused) */
    int   rand_seed;        /* Seed for random number generator */
    int   datatype;         /* Data type flag */
+   int   packed_bits;      /* Store bit genes 64 to a word? */
+   int   narrow_ints;      /* Store integer genes as short/int? */
+   int   float_reals;      /* Store real genes as floats? */
    int   ip_flag;          /* Initial pool generation method flag */
    char  ip_data[80];      /* Data file name (IP_FROM_FILE) */
    int   pool_size;        /* Pool size (IP_RANDOM) */
@@ -138,37 +298,96 @@ typedef struct {
    FN_Ptr   EV_fun;   /* Evaluation */
    FN_Ptr   RE_fun;   /* Replacement */
 
+   /*--- User defined functions (see FN_set_fun()) ---*/
+   FN_Table_Type GA_user, SE_user, X_user, MU_user, RE_user;
+
    /*--- Reports ---*/
    int  rp_type;       /* Type of output report */
    int  rp_interval;   /* Output report interval */
+   int  rp_chroms;     /* Chromosomes listed by long reports (-1: all) */
    FILE *rp_fid;       /* Output report fid */
    char rp_file[80];   /* Output report file name */
 
    /*--- Pools ---*/
    Pool_Ptr old_pool, new_pool;
 
+   /*--- Parallel evaluation ---*/
+   int         eval_threads;   /* Number of evaluation threads */
+   TH_Pool_Ptr th_pool;        /* Threads (only if eval_threads > 1) */
+   int         eval_procs;     /* Number of evaluation processes */
+   char        eval_cmd[80];   /* External evaluator (else fork EV_fun) */
+   PR_Pool_Ptr pr_pool;        /* Processes (only if eval_procs > 0) */
+   Pool_Ptr    kids;           /* Children waiting to be evaluated */
+   Chrom_Ptr   *mates;         /* Parents of kids (by kid index) */
+   int         deterministic;  /* Same results with any number of them? */
+   int         batch;          /* Children per steady state iteration */
+
+   /*--- Parallel reproduction (see breed.c) ---*/
+   int         par_repro;      /* Breed children in parallel? */
+   int         se_ready;       /* Pool prepared by SE_prepare() (read only) */
+   struct GA_Info_Struct **breeder;   /* Copies of ga_info, one per block */
+   int         num_breeders;   /* Number of breeders */
+
+   /*--- Island model (ga islands) ---*/
+   int   islands;          /* Number of islands */
+   int   isl_steady;       /* Islands run steady_state GA (else gener.) */
+   int   mig_interval;     /* Iterations between migrations */
+   int   mig_size;         /* Migrants sent to each neighbor */
+   int   mig_topology;     /* MG_RING, MG_TORUS, MG_FULL */
+   int   mig_replace;      /* MG_WORST, MG_RANDOM */
+   int   net_role;         /* NT_NONE, NT_COORDINATOR, NT_ISLAND */
+   char  net_host[80];     /* Host of coordinator */
+   int   net_port;         /* TCP port of coordinator */
+
+   /*--- Pool monitor in shared memory (see shm.c) ---*/
+   char   shm_name[80];    /* Name of segment ("": none) */
+   int    shm_interval;    /* Iterations between updates */
+   SM_Ptr sm;              /* The segment (only while running) */
+
+   /*--- Cellular GA (ga cellular) ---*/
+   int   grid_width;       /* Width of grid (0: as square as possible) */
+   int   cell_nbhd;        /* CE_VON_NEUMANN, CE_MOORE */
+   int   cell_sweep;       /* CE_SYNC, CE_SWEEP */
+
+   /*--- Work space (never shared between ga_infos) ---*/
+   Chrom_Ptr child1, child2;     /* Children of the current trial */
+   Chrom_Ptr elite;              /* Elite to move in at end of generation */
+   int       ranked;             /* Pool is kept ranked (rank_biased) */
+   char      *x_mask;            /* Mask for X_uox() */
+   int       x_mask_len;         /* Length of x_mask */
+   int       gauss_next;         /* gaussian_random() has a saved value */
+   double    gauss_saved;        /* The saved value */
+   RN_Type   rn;                 /* Random number generator */
+
    /*--- Stats ---*/
    Chrom_Ptr  best;               /* Best chromosome */
    int        num_mut, tot_mut;   /* Mutation statistics */
+   int        best_iter;          /* Iterations done when best was found */
+   double     best_time;          /* Seconds from start until then */
+   double     start_time;         /* When GA_run() started (EX_clock()) */
 } GA_Info_Type, *GA_Info_Ptr;
 
+/*--- Result of one run (see EX_replicate()) ---*/
+typedef struct {
+   int    seed;        /* Random seed of run */
+   double best;        /* Fitness of best chromosome */
+   int    best_iter;   /* Iterations done when it was found */
+   double best_time;   /* Seconds until it was found */
+   double time;        /* Seconds for the whole run */
+} EX_Result_Type, *EX_Result_Ptr;
+
+/*--- Result of a variant in a race (see RA_race()) ---*/
+typedef struct {
+   int    runs;        /* Runs used in the race (one per block) */
+   double sum, sum2;   /* Sum (of squares) of their best fitness */
+   double rank;        /* Mean rank among the variants left then */
+   int    out;         /* Blocks done when it was dropped (0: not dropped) */
+} RA_Result_Type, *RA_Result_Ptr;
+
 /*----------------------------------------------------------------------------
 | Pseudo-functions
 ----------------------------------------------------------------------------*/
-/*--- random number in [0..1] ---*/
-#if defined(__BORLANDC__)
-#define SEED_RAND(seed) (srand((seed)))
-#define RAND_FRAC() ((double)rand()/RAND_MAX)
-#else
-#define SEED_RAND(seed) (srandom((seed)))
-#define RAND_FRAC() ((double)random()*(1.0/2147483647.0))
-#endif
-
-/*--- random number in domain [lo..hi] ---*/
-#define RAND_DOM(lo,hi) ((int) floor(RAND_FRAC()*(((hi)-(lo))+0.999999))+(lo))
-
-/*--- random bit ---*/
-#define RAND_BIT()  ((RAND_FRAC()>=.5)? 1 : 0 )
+/*--- random numbers: see random.c (RN_frac, RN_dom, RN_bit, ...) ---*/
 
 /*--- min and max ---*/
 #define MIN(a,b) ((a < b) ? (a) : (b))
@@ -186,4 +405,14 @@ extern char *FN_name();
 
 extern Chrom_Ptr SE_fun(), CH_alloc();
 extern Pool_Ptr PL_alloc();
-extern GA_Info_Ptr GA_config(), CF_alloc();
+extern Chrom_Ptr PL_new_chrom();
+extern Chrom_Ptr PL_slot();
+extern GA_Info_Ptr GA_config(), CF_alloc(), CF_clone();
+extern TH_Pool_Ptr TH_alloc();
+extern PR_Pool_Ptr PR_alloc();
+extern SM_Ptr SM_create(), SM_attach();
+extern RN_Word RN_next();
+extern double RN_frac();
+extern double CH_gene();
+extern RN_Word RN_bits();
+extern double EX_clock();
@@ -0,0 +1,378 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Island model GA
+|
+| Operators
+|    GA_islands()    - island model GA ("ga islands")
+|       IS_item()    - helper for GA_islands() (one island on one thread)
+|       IS_run()     - initialize an island or run it up to an iteration
+|
+| Utility
+|    IS_migrate()    - send the best of every island to its neighbors
+|    IS_receive()    - put migrants into an island
+|    IS_neighbor()   - neighbors of an island in the migration topology
+|    IS_pick()       - indices of the best or worst chromosomes of a pool
+|    IS_best()       - collect best and convergence of all islands
+|
+| NOTE: Every island is a copy of ga_info (see CF_clone()) with a pool of
+|       pool_size chromosomes and its own random number stream.  It runs
+|       the generational or the steady state GA (island_ga) on a thread of
+|       its own for mig_interval iterations; then the calling thread does
+|       the migration.  The result therefore does not depend on how the
+|       threads are scheduled, but the evaluation function is called from
+|       several threads at once and MUST be thread safe.
+============================================================================*/
+#include "ga.h"
+
+/*--- What each island thread needs ---*/
+typedef struct {
+   GA_Info_Ptr *isl;    /* The islands */
+   int         stop;    /* Run until this iteration (< 0: initialize) */
+} IS_Job_Type, *IS_Job_Ptr;
+
+void IS_item();
+
+/*============================================================================
+|                                Island model GA
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Island model GA
+----------------------------------------------------------------------------*/
+GA_islands(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   GA_Info_Ptr *isl;
+   TH_Pool_Ptr tp;
+   IS_Job_Type job;
+   RN_Type     rn;
+   int         i, num, done;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("GA_islands: invalid ga_info");
+   if(ga_info->ip_flag == IP_INTERACTIVE)
+      UT_error("GA_islands: interactive initpool not supported");
+
+   /*--- Islands in processes of their own? (see net.c) ---*/
+   if(ga_info->net_role == NT_COORDINATOR) return NT_coordinator(ga_info);
+   if(ga_info->net_role == NT_ISLAND)      return NT_island(ga_info);
+
+   /*--- Make the islands, each with a stream of its own ---*/
+   num = ga_info->islands;
+   isl = (GA_Info_Ptr *)calloc(num, sizeof(GA_Info_Ptr));
+   if(isl == NULL) UT_error("GA_islands: alloc failed");
+   rn = ga_info->rn;
+   for(i = 0; i < num; i++) {
+      isl[i] = CF_clone(ga_info);
+      GA_select(isl[i], ga_info->isl_steady ? "steady_state" : "generational");
+      isl[i]->rp_type      = RP_NONE;
+      isl[i]->start_time   = ga_info->start_time;
+      isl[i]->eval_threads = 1;
+      isl[i]->eval_procs   = 0;
+      RN_jump(&rn);
+      isl[i]->rn = rn;
+   }
+
+   /*--- One thread per island ---*/
+   tp = TH_alloc(num);
+   job.isl = isl;
+
+   /*--- Initial pools ---*/
+   job.stop = -1;
+   TH_run(tp, IS_item, (void *)&job, num);
+   IS_best(ga_info, isl, num);
+
+   /*--- Initial pool report ---*/
+   ga_info->iter = -1;
+   RP_islands(ga_info, isl, num);
+
+   /*--- Outer loop is for each migration ---*/
+   for(done = 0; ga_info->max_iter < 0 || done < ga_info->max_iter; ) {
+
+      /*--- Check for convergence (of all islands) ---*/
+      if(ga_info->use_convergence && ga_info->converged) break;
+
+      /*--- Run every island up to the next migration ---*/
+      job.stop = done + ga_info->mig_interval;
+      if(ga_info->max_iter >= 0) job.stop = MIN(job.stop, ga_info->max_iter);
+      TH_run(tp, IS_item, (void *)&job, num);
+      done = job.stop;
+
+      /*--- Migration ---*/
+      IS_migrate(ga_info, isl, num);
+      IS_best(ga_info, isl, num);
+
+      /*--- Print report if appropriate ---*/
+      ga_info->iter = done - 1;
+      RP_islands(ga_info, isl, num);
+   }
+   ga_info->iter = done;
+
+   /*--- Final report ---*/
+   RP_final(ga_info);
+
+   /*--- Clean up ---*/
+   TH_free(tp);
+   for(i = 0; i < num; i++) {
+      GA_done(isl[i]);
+      CF_free(isl[i]);
+   }
+   free(isl);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Initialize island i, or run it up to iteration job->stop
+----------------------------------------------------------------------------*/
+void IS_item(arg, i, id)
+   void *arg;
+   int  i, id;
+{
+   IS_Job_Ptr job;
+
+   job = (IS_Job_Ptr)arg;
+   IS_run(job->isl[i], job->stop);
+}
+
+/*----------------------------------------------------------------------------
+| Initialize an island (stop < 0), or run it up to iteration stop
+----------------------------------------------------------------------------*/
+IS_run(ga_info, stop)
+   GA_Info_Ptr ga_info;
+   int         stop;
+{
+   /*--- Initialize ---*/
+   if(stop < 0) {
+      if(ga_info->isl_steady) GA_ss_init(ga_info);
+      else                    GA_gen_init(ga_info);
+      ga_info->iter = 0;
+      return OK;
+   }
+
+   /*--- Same loop as GA_generational()/GA_steady_state() ---*/
+   for( ; ga_info->iter < stop; ga_info->iter++) {
+
+      /*--- Check for convergence ---*/
+      if(ga_info->use_convergence && ga_info->converged) break;
+
+      /*--- One iteration ---*/
+      if(ga_info->isl_steady) GA_ss_step(ga_info);
+      else                    GA_gen_step(ga_info);
+   }
+
+   return OK;
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Send copies of the mig_size best chromosomes of each island to each of
+| its neighbors
+----------------------------------------------------------------------------*/
+IS_migrate(ga_info, isl, num)
+   GA_Info_Ptr ga_info, *isl;
+   int         num;
+{
+   Chrom_Ptr *mig;
+   Pool_Ptr  pool;
+   int       *idx, i, j, k, n;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("IS_migrate: invalid ga_info");
+   n = ga_info->mig_size;
+   if(n <= 0 || num <= 1) return OK;
+
+   /*--- Room for the migrants of all islands ---*/
+   mig = (Chrom_Ptr *)calloc(num * n, sizeof(Chrom_Ptr));
+   idx = (int *)calloc(n, sizeof(int));
+   if(mig == NULL || idx == NULL) UT_error("IS_migrate: alloc failed");
+
+   /*--- Copy the migrants first, so none are sent twice ---*/
+   for(i = 0; i < num; i++) {
+      pool = isl[i]->old_pool;
+      IS_pick(isl[i], pool, n, TRUE, idx);
+      for(k = 0; k < n; k++) {
+         mig[i*n + k] = CH_alloc(ga_info->chrom_len);
+         CH_copy(pool->chrom[idx[k]], mig[i*n + k]);
+      }
+   }
+
+   /*--- Send them ---*/
+   for(i = 0; i < num; i++)
+      for(k = 0; (j = IS_neighbor(ga_info, i, k, num)) >= 0; k++)
+         IS_receive(isl[j], &mig[i*n], n);
+
+   /*--- Free the copies ---*/
+   for(i = 0; i < num * n; i++) CH_free(mig[i]);
+   free(mig);
+   free(idx);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Put num migrants into an island
+----------------------------------------------------------------------------*/
+IS_receive(ga_info, mig, num)
+   GA_Info_Ptr ga_info;
+   Chrom_Ptr   *mig;
+   int         num;
+{
+   Pool_Ptr pool;
+   int      *idx, i, j;
+
+   pool = ga_info->old_pool;
+   num  = MIN(num, pool->size - 1);
+   if(num <= 0) return OK;
+
+   /*--- Who gets replaced? ---*/
+   idx = (int *)calloc(num, sizeof(int));
+   if(idx == NULL) UT_error("IS_receive: alloc failed");
+   if(ga_info->mig_replace == MG_WORST) {
+      IS_pick(ga_info, pool, num, FALSE, idx);
+   } else {
+      for(i = 0; i < num; i++) {
+         do {
+            idx[i] = RN_dom(&ga_info->rn, 0, pool->size - 1);
+            for(j = 0; j < i && idx[j] != idx[i]; j++)
+               ;
+         } while(idx[i] == pool->best_index || j < i);
+      }
+   }
+
+   /*--- Replace them ---*/
+   for(i = 0; i < num; i++) {
+      PL_insert(pool, idx[i], mig[i], TRUE);
+      if(CH_cmp(ga_info, mig[i], ga_info->best) < 0) {
+         CH_copy(mig[i], ga_info->best);
+         ga_info->best_iter = ga_info->iter;
+         ga_info->best_time = EX_clock() - ga_info->start_time;
+      }
+   }
+   free(idx);
+
+   /*--- Keep pool in order for by_rank replacement ---*/
+   if(!strcmp(RE_name(ga_info), "by_rank")) PL_sort(ga_info, pool);
+
+   /*--- New statistics (and maybe no longer converged) ---*/
+   PL_stats(ga_info, pool);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| The k-th neighbor of island i (k = 0, 1, ...), -1 if there is none
+|
+|   MG_RING:  island i+1
+|   MG_TORUS: islands right, left, below and above on a rows x cols torus,
+|             rows being the largest divisor of num not above sqrt(num)
+|   MG_FULL:  all other islands
+----------------------------------------------------------------------------*/
+IS_neighbor(ga_info, i, k, num)
+   GA_Info_Ptr ga_info;
+   int         i, k, num;
+{
+   int nb[4], rows, cols, r, c, j, m, n;
+
+   if(num <= 1) return -1;
+
+   switch(ga_info->mig_topology) {
+
+      case MG_RING:
+         return (k == 0) ? (i + 1) % num : -1;
+
+      case MG_FULL:
+         if(k >= num - 1) return -1;
+         return (k < i) ? k : k + 1;
+
+      case MG_TORUS:
+         /*--- Shape of torus ---*/
+         for(rows = (int)sqrt((double)num); num % rows != 0; rows--)
+            ;
+         cols = num / rows;
+         r    = i / cols;
+         c    = i % cols;
+
+         /*--- Right, left, below, above ---*/
+         nb[0] = r * cols + (c + 1) % cols;
+         nb[1] = r * cols + (c + cols - 1) % cols;
+         nb[2] = ((r + 1) % rows) * cols + c;
+         nb[3] = ((r + rows - 1) % rows) * cols + c;
+
+         /*--- k-th one that is neither i nor a duplicate ---*/
+         for(j = 0, n = 0; j < 4; j++) {
+            if(nb[j] == i) continue;
+            for(m = 0; m < j && nb[m] != nb[j]; m++)
+               ;
+            if(m < j) continue;
+            if(n++ == k) return nb[j];
+         }
+         return -1;
+
+      default: UT_error("IS_neighbor: invalid mig_topology");
+   }
+   return -1;
+}
+
+/*----------------------------------------------------------------------------
+| Indices of the num best (best = TRUE) or worst chromosomes of pool
+----------------------------------------------------------------------------*/
+IS_pick(ga_info, pool, num, best, idx)
+   GA_Info_Ptr ga_info;
+   Pool_Ptr    pool;
+   int         num, best, *idx;
+{
+   int i, j, k, cmp;
+
+   for(k = 0; k < num && k < pool->size; k++) {
+      idx[k] = -1;
+      for(i = 0; i < pool->size; i++) {
+
+         /*--- Already picked? ---*/
+         for(j = 0; j < k && idx[j] != i; j++)
+            ;
+         if(j < k) continue;
+
+         /*--- Better (or worse) than the one so far? ---*/
+         if(idx[k] < 0) {
+            idx[k] = i;
+         } else {
+            cmp = CH_cmp(ga_info, pool->chrom[i], pool->chrom[idx[k]]);
+            if((best && cmp < 0) || (!best && cmp > 0)) idx[k] = i;
+         }
+      }
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Best of all islands into ga_info->best, converged if all islands are
+----------------------------------------------------------------------------*/
+IS_best(ga_info, isl, num)
+   GA_Info_Ptr ga_info, *isl;
+   int         num;
+{
+   int i, b;
+
+   /*--- Make sure best is allocated ---*/
+   if(!CH_valid(ga_info->best))
+      ga_info->best = CH_alloc(ga_info->chrom_len);
+
+   ga_info->converged = TRUE;
+   ga_info->tot_mut   = 0;
+   ga_info->num_mut   = 0;
+   for(i = 0, b = 0; i < num; i++) {
+      if(CH_cmp(ga_info, isl[i]->best, isl[b]->best) < 0) b = i;
+      if(!isl[i]->converged) ga_info->converged = FALSE;
+      ga_info->tot_mut += isl[i]->tot_mut;
+      ga_info->num_mut += isl[i]->num_mut;
+   }
+   CH_copy(isl[b]->best, ga_info->best);
+   ga_info->best_iter = isl[b]->best_iter;
+   ga_info->best_time = isl[b]->best_time;
+
+   return OK;
+}
@@ -16,6 +16,10 @@
 |    MU_select()  - select mutation function by name
 |    MU_name()    - get name of current mutation function
 |    MU_fun()     - setup and perform current mutation operator
+|
+| NOTE: the bit operators and MU_swap() also take packed bit strings
+|       (ST_BITS) and narrow integer genes (ST_INT16, ST_INT32); the float
+|       operators and MU_swap() take float genes (ST_FLOAT) as well.
 ============================================================================*/
 #include "ga.h"
 
@@ -23,7 +27,7 @@ int MU_simple_invert(), MU_simple_random(), MU_swap();
  /* rnd float in [0..1] -- introduced by claudio 10/02/2004 */
 int MU_float_random(), MU_float_rnd_pert(), MU_float_LS(), MU_float_gauss_pert();
 
-double gaussian_random(void);
+double gaussian_random();
 
 /*============================================================================
 |                     Mutation interface
@@ -51,7 +55,8 @@ MU_set_fun(ga_info, fn_name, fn_ptr)
    char         *fn_name;
    FN_Ptr       fn_ptr;
 {
-   return FN_set_fun(ga_info, MU_table, fn_name, fn_ptr, &ga_info->MU_fun);
+   return FN_set_fun(ga_info, &ga_info->MU_user, fn_name, fn_ptr, 
+                     &ga_info->MU_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -61,7 +66,8 @@ MU_select(ga_info, fn_name)
    GA_Info_Ptr  ga_info;
    char         *fn_name;
 {
-   return FN_select(ga_info, MU_table, fn_name, &ga_info->MU_fun);
+   return FN_select(ga_info, MU_table, &ga_info->MU_user, fn_name, 
+                    &ga_info->MU_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -70,7 +76,7 @@ MU_select(ga_info, fn_name)
 char *MU_name(ga_info)
    GA_Info_Ptr  ga_info;
 {
-   return FN_name(ga_info, MU_table, ga_info->MU_fun);
+   return FN_name(ga_info, MU_table, &ga_info->MU_user, ga_info->MU_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -81,7 +87,7 @@ MU_fun(ga_info, chrom)
    Chrom_Ptr   chrom;
 {
    /*--- Random chance to mutate ---*/
-   if(RAND_FRAC() <= ga_info->mu_rate && ga_info->MU_fun != NULL) {
+   if(RN_frac(&ga_info->rn) <= ga_info->mu_rate && ga_info->MU_fun != NULL) {
       ga_info->MU_fun(ga_info, chrom);
       ga_info->num_mut++;
       ga_info->tot_mut++;
@@ -101,10 +107,15 @@ MU_simple_invert(ga_info, chrom)
    int idx;
 
    /*--- Select bit at random ---*/
-   idx = RAND_DOM(chrom->idx_min, chrom->length-1);
+   idx = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
 
    /*--- Invert selected bit ---*/
-   chrom->gene[idx] = chrom->gene[idx] ? 0 : 1;
+   if(chrom->store == ST_BITS)
+      chrom->word[idx / CH_WORD_BITS] ^= (CH_Word)1 << (idx % CH_WORD_BITS);
+   else if(chrom->store != ST_DOUBLE)
+      CH_SET_INT(chrom, idx, CH_INT(chrom, idx) ? 0 : 1);
+   else
+      chrom->gene[idx] = chrom->gene[idx] ? 0 : 1;
 }
 
 /*----------------------------------------------------------------------------
@@ -117,10 +128,13 @@ MU_simple_random(ga_info, chrom)
    int idx;
 
    /*--- Select bit at random ---*/
-   idx = RAND_DOM(chrom->idx_min, chrom->length-1);
+   idx = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
 
    /*--- Assign random value to bit ---*/
-   chrom->gene[idx] = RAND_BIT();
+   if(chrom->store != ST_DOUBLE)
+      CH_set(chrom, idx, (double)RN_bit(&ga_info->rn));
+   else
+      chrom->gene[idx] = RN_bit(&ga_info->rn);
 }
 
 /*----------------------------------------------------------------------------
@@ -131,13 +145,24 @@ MU_swap(ga_info, chrom)
    Chrom_Ptr chrom;
 {
    Gene_Type tmp;
-   int       i, j;
+   int       i, j, t;
 
    /*--- Select two bits at random (can be same) ---*/
-   i = RAND_DOM(chrom->idx_min, chrom->length-1);
-   j = RAND_DOM(chrom->idx_min, chrom->length-1);
+   i = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
+   j = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
 
    /*--- Swap the elements ---*/
+   if(chrom->store == ST_BITS || chrom->store == ST_FLOAT) {
+      tmp = CH_gene(chrom, i);
+      CH_set(chrom, i, CH_gene(chrom, j));
+      CH_set(chrom, j, tmp);
+      return OK;
+   } else if(chrom->store != ST_DOUBLE) {
+      t = CH_INT(chrom, i);
+      CH_MOVE(chrom, i, chrom, j);
+      CH_SET_INT(chrom, j, t);
+      return OK;
+   }
    tmp            = chrom->gene[i];
    chrom->gene[i] = chrom->gene[j];
    chrom->gene[j] = tmp;
@@ -152,26 +177,29 @@ MU_float_rnd_pert(ga_info, chrom)
    Chrom_Ptr chrom;
 {
    int       i;
+   double    gene;
 
    /*--- Select one element at random ---*/
-   i = RAND_DOM(chrom->idx_min, chrom->length-1);
+   i = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
 
    if(i==6)
      {
        /*--- Generate random element ---*/
-       chrom->gene[i] = RAND_FRAC();
+       gene = RN_frac(&ga_info->rn);
      }
    else
      {
        /*--- Generate randomly perturbed element ---*/
-       chrom->gene[i] += ga_info->pert_range*(1.0 - 2.0*RAND_FRAC());
+       gene = CH_REAL(chrom, i) +
+              ga_info->pert_range*(1.0 - 2.0*RN_frac(&ga_info->rn));
      }
    //   printf("gene %d, bias %g\n",i,ga_info->mut_bias[i]);
    
-   if( chrom->gene[i]>1)
-     chrom->gene[i]=1;
-   if( chrom->gene[i]<0)
-     chrom->gene[i]=0;
+   if( gene>1)
+     gene=1;
+   if( gene<0)
+     gene=0;
+   CH_SET_REAL(chrom, i, gene);
 }
 
 
@@ -183,18 +211,19 @@ MU_float_random(ga_info, chrom)
    Chrom_Ptr chrom;
 {
    int       i;
+   double    gene;
 
    /*--- Select one element at random ---*/
-   i = RAND_DOM(chrom->idx_min, chrom->length-1);
+   i = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
 
    /*--- Generate random element ---*/
-   chrom->gene[i] = RAND_FRAC();
-   if( chrom->gene[i]>1)
-     chrom->gene[i]=1;
-   if( chrom->gene[i]<0)
-     chrom->gene[i]=0;
+   gene = RN_frac(&ga_info->rn);
+   if( gene>1)
+     gene=1;
+   if( gene<0)
+     gene=0;
 
-   chrom->gene[i] = chrom->gene[i]*2-1;
+   CH_SET_REAL(chrom, i, gene*2-1);
 
 }
 
@@ -208,6 +237,7 @@ MU_float_LS(ga_info, chrom)
 
   int   i;
   float old_fit, new_fit, prev_fit, prev_val,tmp;
+  double gene;
   
 
   while(1)
@@ -218,20 +248,21 @@ MU_float_LS(ga_info, chrom)
       for(i=chrom->idx_min;i<chrom->length;i++)
 	{
 	  prev_fit=chrom->fitness;
-	  prev_val= chrom->gene[i];
+	  prev_val= CH_REAL(chrom, i);
 	  
-	  chrom->gene[i] += 0.1*(1.0 - 2.0*RAND_FRAC());
-	  if( chrom->gene[i]>1)
-	    chrom->gene[i]=1;
-	  if( chrom->gene[i]<0)
-	    chrom->gene[i]=0;
+	  gene = CH_REAL(chrom, i) + 0.1*(1.0 - 2.0*RN_frac(&ga_info->rn));
+	  if( gene>1)
+	    gene=1;
+	  if( gene<0)
+	    gene=0;
+	  CH_SET_REAL(chrom, i, gene);
 	  
-	  obj_fun(chrom);
+	  ga_info->EV_fun(chrom);
 	  new_fit=chrom->fitness;
 	  
 	  if(new_fit>prev_fit)
 	    {
-	      chrom->gene[i]=prev_val;
+	      CH_SET_REAL(chrom, i, prev_val);
 	      chrom->fitness=prev_fit;
 	    }
 	}
@@ -265,15 +296,15 @@ MU_float_gauss_pert(ga_info, chrom)
    
 
    // NB pert in [-1,1], gaussian: mean=0, var=1
-   pert=(2*(RAND_DOM(0,c2)+RAND_DOM(0,c2)+RAND_DOM(0,c2))-3*(c2))*c3;
+   pert=(2*(RN_dom(&ga_info->rn, 0,c2)+RN_dom(&ga_info->rn, 0,c2)+RN_dom(&ga_info->rn, 0,c2))-3*(c2))*c3;
 
-   //pert=gaussian_random();
+   //pert=gaussian_random(ga_info);
 
    /*--- Select one element at random ---*/
-   i = RAND_DOM(chrom->idx_min, chrom->length-1);
+   i = RN_dom(&ga_info->rn, chrom->idx_min, chrom->length-1);
 
    /*--- Generate randomly perturbed element ---*/
-   chrom->gene[i] += ga_info->pert_range*pert;
+   CH_SET_REAL(chrom, i, CH_REAL(chrom, i) + ga_info->pert_range*pert);
 
    //   printf("gene %d, bias %g\n",i,ga_info->mut_bias[i]);
    
@@ -282,26 +313,24 @@ MU_float_gauss_pert(ga_info, chrom)
 
 
 
-double gaussian_random(void)
+double gaussian_random(ga_info)
+   GA_Info_Ptr ga_info;
 {
-  static int next_gaussian = 0;
-  static double saved_gaussian_value;
-
   double fac, rsq, v1, v2;
 
-  if (next_gaussian == 0) {
+  if (ga_info->gauss_next == 0) {
     do {
-      v1 = 2.0*RAND_FRAC()-1.0;
-      v2 = 2.0*RAND_FRAC()-1.0;
+      v1 = 2.0*RN_frac(&ga_info->rn)-1.0;
+      v2 = 2.0*RN_frac(&ga_info->rn)-1.0;
       rsq = v1*v1+v2*v2;
     } while (rsq >= 1.0 || rsq == 0.0);
     fac = sqrt(-2.0*log(rsq)/rsq);
-    saved_gaussian_value=v1*fac;
-    next_gaussian=1;
+    ga_info->gauss_saved=v1*fac;
+    ga_info->gauss_next=1;
     return v2*fac;
   } else {
-    next_gaussian=0;
-    return saved_gaussian_value;
+    ga_info->gauss_next=0;
+    return ga_info->gauss_saved;
   }
 }
 
@@ -0,0 +1,663 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Island model GA with islands in processes of their own (over TCP)
+|
+| Operators
+|    NT_coordinator() - coordinate islands ("ga islands", "net_role coordinator")
+|    NT_island()      - run one island ("ga islands", "net_role island")
+|
+| Utility
+|    NT_listen()      - wait for all islands to connect
+|    NT_connect()     - connect to the coordinator
+|    NT_gather()      - receive a message from every island still there
+|    NT_best()        - collect best and convergence of all islands
+|    NT_lost()        - forget an island that is gone
+|    NT_send()        - send a message
+|    NT_recv()        - receive a message
+|    NT_size()        - size of the body of a message
+|    NT_put()         - chromosomes into the body of a message
+|    NT_get()         - chromosomes out of the body of a message
+|
+| NOTE: The coordinator runs no GA itself.  It waits for "islands" island
+|       processes to connect to net_host:net_port (one island each), then
+|       does what GA_islands() does with its threads: it tells them how
+|       far to run, passes the migrants on (through it, never between
+|       islands) and collects the best chromosome and pool statistics of
+|       all of them for the reports.  Islands are numbered in the order in
+|       which they connect and use the random number streams they would
+|       have in GA_islands() with the coordinator's rand_seed, so the
+|       result is the same as with threads.
+|
+|       An island that closes its connection (e.g. because it crashed) is
+|       dropped: the others go on with the migration topology of those
+|       left, and its best chromosome still counts.  If the coordinator is
+|       gone, islands stop and report what they have.  A process that
+|       hangs without closing its connection stalls the run.
+|
+| Protocol (binary, in the byte order of the machine): a header of five
+| ints, type, island, iter, num and len, then (STATS only) NT_NUM_STATS
+| doubles, then num chromosomes of len genes (Gene_Type) and their fitness
+| (double) each.  Fields not listed are 0.
+|
+|    island      -> coordinator  HELLO     iter = NT_MAGIC, len = chrom_len,
+|                                          island = sizeof(Gene_Type)
+|    coordinator -> island       WELCOME   island = its number, num = number
+|                                          of islands, iter = rand_seed
+|    island      -> coordinator  STATS     statistics and best chromosome
+|    coordinator -> island       RUN       run up to iteration iter
+|                                STOP      done
+|    island      -> coordinator  MIGRANTS  its mig_size best chromosomes
+|    coordinator -> island       MIGRANTS  those of its neighbors, mig_size
+|                                          at a time
+|
+|    After WELCOME and after each migration the island sends STATS; after
+|    each RUN it sends its MIGRANTS and gets those of its neighbors.
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define NT_MAGIC     0x4C474131   /* "LGA1", also checks byte order */
+#define NT_NUM_STATS 12           /* Doubles of statistics in STATS */
+#define NT_WAIT      30           /* Seconds to wait for the coordinator */
+
+/*--- Message types ---*/
+#define NT_HELLO    1
+#define NT_WELCOME  2
+#define NT_STATS    3
+#define NT_RUN      4
+#define NT_STOP     5
+#define NT_MIGRANTS 6
+
+/*--- Message header ---*/
+typedef struct {
+   int type, island, iter, num, len;
+} NT_Head_Type, *NT_Head_Ptr;
+
+#define NT_BODY(msg) ((msg) + sizeof(NT_Head_Type))
+
+/*--- Islands as seen by the coordinator ---*/
+typedef struct {
+   GA_Info_Ptr ga_info;    /* The coordinator */
+   int         num;        /* Number of islands */
+   int         *fd;        /* Connection of each (-1: gone) */
+   int         *heard;     /* Has it sent its statistics yet? */
+   GA_Info_Ptr *isl;       /* Each island: best, converged, mutations */
+   Pool_Type   *pool;      /* Statistics of each island's pool */
+   Chrom_Ptr   *mig;       /* Migrants of each island (mig_size each) */
+   char        *msg;       /* Message buffer */
+   int         msg_size;   /* Size of message buffer (bytes) */
+} NT_Type, *NT_Ptr;
+
+int *NT_listen();
+
+/*============================================================================
+|                                Coordinator
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Coordinator of island processes (same loop as GA_islands())
+----------------------------------------------------------------------------*/
+NT_coordinator(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   NT_Type     nt;
+   GA_Info_Ptr *live;
+   char        *body;
+   int         *who, i, j, k, a, b, n, m, num_live, done, stop;
+
+   /*--- Wait for the islands ---*/
+   signal(SIGPIPE, SIG_IGN);
+   nt.ga_info = ga_info;
+   nt.num     = ga_info->islands;
+   nt.fd      = NT_listen(ga_info, nt.num);
+   n          = ga_info->mig_size;
+
+   /*--- What we know about each of them ---*/
+   nt.isl  = (GA_Info_Ptr *)calloc(nt.num, sizeof(GA_Info_Ptr));
+   nt.pool = (Pool_Type *)calloc(nt.num, sizeof(Pool_Type));
+   nt.mig  = (Chrom_Ptr *)calloc(nt.num * n + 1, sizeof(Chrom_Ptr));
+   live    = (GA_Info_Ptr *)calloc(nt.num, sizeof(GA_Info_Ptr));
+   who     = (int *)calloc(nt.num, sizeof(int));
+   nt.heard = (int *)calloc(nt.num, sizeof(int));
+   nt.msg_size = sizeof(NT_Head_Type) +
+                 NT_size(NT_STATS, MAX(1, nt.num * n), ga_info->chrom_len);
+   nt.msg  = (char *)malloc(nt.msg_size);
+   if(nt.isl == NULL || nt.pool == NULL || nt.mig == NULL || live == NULL ||
+      who == NULL || nt.heard == NULL || nt.msg == NULL)
+      UT_error("NT_coordinator: alloc failed");
+   for(i = 0; i < nt.num; i++) {
+      nt.isl[i] = CF_clone(ga_info);
+      nt.isl[i]->old_pool = &nt.pool[i];
+      nt.isl[i]->best     = CH_alloc(ga_info->chrom_len);
+      nt.pool[i].magic_cookie = PL_cookie;
+   }
+   for(i = 0; i < nt.num * n; i++) nt.mig[i] = CH_alloc(ga_info->chrom_len);
+   body = NT_BODY(nt.msg);
+
+   /*--- Initial pools ---*/
+   for(i = 0; i < nt.num; i++)
+      if(NT_send(nt.fd[i], nt.msg, NT_WELCOME, i, ga_info->rand_seed, nt.num,
+                 ga_info->chrom_len, 0) != OK) NT_lost(&nt, i);
+   NT_gather(&nt, NT_STATS);
+   num_live = NT_best(&nt, live);
+
+   /*--- Initial pool report ---*/
+   ga_info->iter = -1;
+   if(num_live > 0) RP_islands(ga_info, live, num_live);
+
+   /*--- Outer loop is for each migration ---*/
+   for(done = 0; ga_info->max_iter < 0 || done < ga_info->max_iter; ) {
+
+      /*--- Check for convergence (of all islands), or none left ---*/
+      if(ga_info->use_convergence && ga_info->converged) break;
+      if(num_live == 0) {
+         UT_warn("NT_coordinator: all islands lost");
+         break;
+      }
+
+      /*--- Run every island up to the next migration ---*/
+      stop = done + ga_info->mig_interval;
+      if(ga_info->max_iter >= 0) stop = MIN(stop, ga_info->max_iter);
+      for(i = 0; i < nt.num; i++)
+         if(nt.fd[i] >= 0 &&
+            NT_send(nt.fd[i], nt.msg, NT_RUN, i, stop, 0, 0, 0) != OK)
+            NT_lost(&nt, i);
+      done = stop;
+
+      /*--- Migration: as IS_migrate(), among the islands left ---*/
+      NT_gather(&nt, NT_MIGRANTS);
+      for(i = 0, num_live = 0; i < nt.num; i++)
+         if(nt.fd[i] >= 0) who[num_live++] = i;
+      for(b = 0; b < num_live; b++) {
+
+         /*--- Migrants of every island that island b is a neighbor of ---*/
+         for(a = 0, m = 0; a < num_live && n > 0; a++)
+            for(k = 0; (j = IS_neighbor(ga_info, a, k, num_live)) >= 0; k++)
+               if(j == b) {
+                  NT_put(body + NT_size(NT_MIGRANTS, m, ga_info->chrom_len),
+                         &nt.mig[who[a] * n], n);
+                  m += n;
+               }
+         if(NT_send(nt.fd[who[b]], nt.msg, NT_MIGRANTS, who[b], done, m,
+                    ga_info->chrom_len,
+                    NT_size(NT_MIGRANTS, m, ga_info->chrom_len)) != OK)
+            NT_lost(&nt, who[b]);
+      }
+
+      /*--- Statistics ---*/
+      NT_gather(&nt, NT_STATS);
+      num_live = NT_best(&nt, live);
+
+      /*--- Print report if appropriate ---*/
+      ga_info->iter = done - 1;
+      if(num_live > 0) RP_islands(ga_info, live, num_live);
+   }
+   ga_info->iter = done;
+
+   /*--- Tell the islands to stop ---*/
+   for(i = 0; i < nt.num; i++)
+      if(nt.fd[i] >= 0) {
+         NT_send(nt.fd[i], nt.msg, NT_STOP, i, done, 0, 0, 0);
+         close(nt.fd[i]);
+      }
+
+   /*--- Final report ---*/
+   RP_final(ga_info);
+
+   /*--- Clean up ---*/
+   for(i = 0; i < nt.num; i++) {
+      nt.isl[i]->old_pool = NULL;
+      CH_free(nt.isl[i]->best);
+      nt.isl[i]->best = NULL;
+      CF_free(nt.isl[i]);
+   }
+   for(i = 0; i < nt.num * n; i++) CH_free(nt.mig[i]);
+   free(nt.fd);
+   free(nt.heard);
+   free(nt.isl);
+   free(nt.pool);
+   free(nt.mig);
+   free(nt.msg);
+   free(live);
+   free(who);
+
+   return OK;
+}
+
+/*============================================================================
+|                                   Island
+============================================================================*/
+/*----------------------------------------------------------------------------
+| One island of a coordinator (same as IS_item(), with migration by message)
+----------------------------------------------------------------------------*/
+NT_island(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   GA_Info_Ptr isl;
+   NT_Head_Ptr head;
+   Chrom_Ptr   *mig;
+   RN_Type     rn;
+   double      *st;
+   char        *msg, *body;
+   int         fd, i, n, num, max_mig, msg_size, stopped, *idx;
+
+   /*--- Say hello ---*/
+   signal(SIGPIPE, SIG_IGN);
+   fd  = NT_connect(ga_info);
+   msg = (char *)malloc(sizeof(NT_Head_Type));
+   if(msg == NULL) UT_error("NT_island: alloc failed");
+   head = (NT_Head_Ptr)msg;
+   if(NT_send(fd, msg, NT_HELLO, (int)sizeof(Gene_Type), NT_MAGIC, 0,
+              ga_info->chrom_len, 0) != OK ||
+      NT_recv(fd, msg, sizeof(NT_Head_Type), NT_WELCOME) != OK)
+      UT_error("NT_island: coordinator did not answer");
+   head = (NT_Head_Ptr)msg;
+   num  = head->num;
+
+   /*--- The island, with the stream it has in GA_islands() ---*/
+   isl = CF_clone(ga_info);
+   GA_select(isl, ga_info->isl_steady ? "steady_state" : "generational");
+   isl->rp_type    = RP_NONE;
+   isl->start_time = ga_info->start_time;
+   RN_seed(&rn, head->iter);
+   for(i = 0; i <= head->island; i++) RN_jump(&rn);
+   isl->rn = rn;
+
+   /*--- Its own evaluation processes or threads (as GA_run()) ---*/
+   if(isl->eval_procs > 0)
+      isl->pr_pool = PR_alloc(isl->eval_procs, isl->eval_cmd, isl->EV_fun);
+   else if(isl->eval_threads > 1)
+      isl->th_pool = TH_alloc(isl->eval_threads);
+
+   /*--- Room for messages and migrants ---*/
+   n       = ga_info->mig_size;
+   max_mig = MAX(1, num * n);
+   free(msg);
+   msg_size = sizeof(NT_Head_Type) +
+              NT_size(NT_STATS, max_mig, ga_info->chrom_len);
+   msg = (char *)malloc(msg_size);
+   mig = (Chrom_Ptr *)calloc(max_mig, sizeof(Chrom_Ptr));
+   idx = (int *)calloc(max_mig, sizeof(int));
+   if(msg == NULL || mig == NULL || idx == NULL)
+      UT_error("NT_island: alloc failed");
+   for(i = 0; i < max_mig; i++) mig[i] = CH_alloc(ga_info->chrom_len);
+   body = NT_BODY(msg);
+
+   /*--- Initial pool ---*/
+   IS_run(isl, -1);
+
+   for(stopped = FALSE; !stopped; ) {
+
+      /*--- Statistics and best ---*/
+      st = (double *)body;
+      st[0]  = isl->old_pool->size;
+      st[1]  = isl->old_pool->total_fitness;
+      st[2]  = isl->old_pool->min;
+      st[3]  = isl->old_pool->max;
+      st[4]  = isl->old_pool->ave;
+      st[5]  = isl->old_pool->var;
+      st[6]  = isl->old_pool->dev;
+      st[7]  = isl->converged;
+      st[8]  = isl->num_mut;
+      st[9]  = isl->tot_mut;
+      st[10] = isl->best_iter;
+      st[11] = isl->best_time;
+      NT_put(body + NT_NUM_STATS * sizeof(double), &isl->best, 1);
+      if(NT_send(fd, msg, NT_STATS, 0, isl->iter, 1, ga_info->chrom_len,
+                 NT_size(NT_STATS, 1, ga_info->chrom_len)) != OK) break;
+
+      /*--- Run up to the next migration, or stop ---*/
+      if(NT_recv(fd, msg, msg_size, -1) != OK) break;
+      head = (NT_Head_Ptr)msg;
+      if(head->type == NT_STOP) stopped = TRUE;
+      if(head->type != NT_RUN) continue;
+      IS_run(isl, head->iter);
+
+      /*--- Send our best, get those of our neighbors ---*/
+      if(n > 0 && isl->old_pool->size > 0) {
+         IS_pick(isl, isl->old_pool, n, TRUE, idx);
+         for(i = 0; i < n; i++) CH_copy(isl->old_pool->chrom[idx[i]], mig[i]);
+      } else
+         n = 0;
+      NT_put(body, mig, n);
+      if(NT_send(fd, msg, NT_MIGRANTS, 0, isl->iter, n, ga_info->chrom_len,
+                 NT_size(NT_MIGRANTS, n, ga_info->chrom_len)) != OK ||
+         NT_recv(fd, msg, msg_size, NT_MIGRANTS) != OK ||
+         head->num > max_mig || head->len != ga_info->chrom_len) break;
+      NT_get(body, mig, head->num);
+      for(i = 0; n > 0 && i + n <= head->num; i += n)
+         IS_receive(isl, &mig[i], n);
+      n = ga_info->mig_size;
+   }
+   if(!stopped) UT_warn("NT_island: lost coordinator");
+   close(fd);
+
+   /*--- Results (as in IS_best()) ---*/
+   if(!CH_valid(ga_info->best)) ga_info->best = CH_alloc(ga_info->chrom_len);
+   CH_copy(isl->best, ga_info->best);
+   ga_info->iter      = isl->iter;
+   ga_info->converged = isl->converged;
+   ga_info->num_mut   = isl->num_mut;
+   ga_info->tot_mut   = isl->tot_mut;
+   ga_info->best_iter = isl->best_iter;
+   ga_info->best_time = isl->best_time;
+
+   /*--- Final report ---*/
+   RP_final(ga_info);
+
+   /*--- Clean up ---*/
+   TH_free(isl->th_pool);
+   isl->th_pool = NULL;
+   PR_free(isl->pr_pool);
+   isl->pr_pool = NULL;
+   GA_done(isl);
+   CF_free(isl);
+   for(i = 0; i < max_mig; i++) CH_free(mig[i]);
+   free(mig);
+   free(idx);
+   free(msg);
+
+   return OK;
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Wait for num islands to connect to net_host:net_port and say hello
+|
+| Returns their connections; sets ga_info->chrom_len to theirs.
+----------------------------------------------------------------------------*/
+int *NT_listen(ga_info, num)
+   GA_Info_Ptr ga_info;
+   int         num;
+{
+   struct addrinfo hints, *ai;
+   NT_Head_Type    head;
+   char            port[20];
+   int             *fd, s, c, i, on = 1;
+
+   fd = (int *)calloc(num, sizeof(int));
+   if(fd == NULL) UT_error("NT_listen: alloc failed");
+
+   /*--- Listen on net_host:net_port ---*/
+   memset(&hints, 0, sizeof(hints));
+   hints.ai_family   = AF_INET;
+   hints.ai_socktype = SOCK_STREAM;
+   hints.ai_flags    = AI_PASSIVE;
+   sprintf(port, "%d", ga_info->net_port);
+   if(getaddrinfo(ga_info->net_host, port, &hints, &ai) != 0)
+      UT_error("NT_listen: unknown net_host");
+   if((s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0)
+      UT_error("NT_listen: socket failed");
+   setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (char *)&on, sizeof(on));
+   if(bind(s, ai->ai_addr, ai->ai_addrlen) < 0 || listen(s, num) < 0)
+      UT_error("NT_listen: cannot listen on net_port");
+   freeaddrinfo(ai);
+
+   /*--- Accept islands until there are num of them ---*/
+   for(i = 0; i < num; ) {
+      if((c = accept(s, NULL, NULL)) < 0) continue;
+      setsockopt(c, IPPROTO_TCP, TCP_NODELAY, (char *)&on, sizeof(on));
+
+      /*--- Hello: same protocol, gene type and chrom_len? ---*/
+      if(PR_read(c, (char *)&head, sizeof(head)) != OK ||
+         head.type != NT_HELLO || head.iter != NT_MAGIC ||
+         head.island != (int)sizeof(Gene_Type) || head.len <= 0 ||
+         (i > 0 && head.len != ga_info->chrom_len)) {
+         UT_warn("NT_listen: bad hello, connection closed");
+         close(c);
+         continue;
+      }
+      ga_info->chrom_len = head.len;
+      fd[i++] = c;
+   }
+   close(s);
+
+   return fd;
+}
+
+/*----------------------------------------------------------------------------
+| Connect to the coordinator at net_host:net_port (it may not be up yet)
+----------------------------------------------------------------------------*/
+NT_connect(ga_info)
+   GA_Info_Ptr ga_info;
+{
+   struct addrinfo hints, *ai;
+   char            port[20];
+   int             s, t, on = 1;
+
+   memset(&hints, 0, sizeof(hints));
+   hints.ai_family   = AF_INET;
+   hints.ai_socktype = SOCK_STREAM;
+   sprintf(port, "%d", ga_info->net_port);
+   if(getaddrinfo(ga_info->net_host, port, &hints, &ai) != 0)
+      UT_error("NT_connect: unknown net_host");
+
+   /*--- Try every 0.1 seconds for NT_WAIT seconds ---*/
+   for(t = 0; ; t++) {
+      if((s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0)
+         UT_error("NT_connect: socket failed");
+      if(connect(s, ai->ai_addr, ai->ai_addrlen) == 0) break;
+      close(s);
+      if(t >= NT_WAIT * 10) UT_error("NT_connect: no coordinator");
+      usleep(100000);
+   }
+   freeaddrinfo(ai);
+   setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (char *)&on, sizeof(on));
+
+   return s;
+}
+
+/*----------------------------------------------------------------------------
+| Receive a message of the given type from every island still there:
+| statistics and best (NT_STATS) or migrants (NT_MIGRANTS)
+----------------------------------------------------------------------------*/
+NT_gather(nt, type)
+   NT_Ptr nt;
+   int    type;
+{
+   NT_Head_Ptr head;
+   GA_Info_Ptr isl;
+   Pool_Ptr    pool;
+   double      *st;
+   char        *body;
+   int         i, n;
+
+   n = nt->ga_info->mig_size;
+   for(i = 0; i < nt->num; i++) {
+      if(nt->fd[i] < 0) continue;
+
+      /*--- Receive it (and check it) ---*/
+      if(NT_recv(nt->fd[i], nt->msg, nt->msg_size, type) != OK) {
+         NT_lost(nt, i);
+         continue;
+      }
+      head = (NT_Head_Ptr)nt->msg;
+      body = NT_BODY(nt->msg);
+      if(head->len != nt->ga_info->chrom_len ||
+         head->num != ((type == NT_STATS) ? 1 : n)) {
+         NT_lost(nt, i);
+         continue;
+      }
+
+      /*--- Migrants ---*/
+      if(type == NT_MIGRANTS) {
+         NT_get(body, &nt->mig[i * n], n);
+         continue;
+      }
+
+      /*--- Statistics and best ---*/
+      isl  = nt->isl[i];
+      pool = &nt->pool[i];
+      st   = (double *)body;
+      pool->size          = (int)st[0];
+      pool->total_fitness = st[1];
+      pool->min           = st[2];
+      pool->max           = st[3];
+      pool->ave           = st[4];
+      pool->var           = st[5];
+      pool->dev           = st[6];
+      isl->converged      = (int)st[7];
+      isl->num_mut        = (int)st[8];
+      isl->tot_mut        = (int)st[9];
+      isl->best_iter      = (int)st[10];
+      isl->best_time      = st[11];
+      NT_get(body + NT_NUM_STATS * sizeof(double), &isl->best, 1);
+      nt->heard[i] = TRUE;
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Best of all islands that have sent their statistics (see IS_best());
+| live receives the islands still there, their number is returned
+----------------------------------------------------------------------------*/
+NT_best(nt, live)
+   NT_Ptr      nt;
+   GA_Info_Ptr *live;
+{
+   int i, num;
+
+   for(i = 0, num = 0; i < nt->num; i++)
+      if(nt->heard[i]) live[num++] = nt->isl[i];
+   if(num == 0) UT_error("NT_coordinator: no island has reported");
+   IS_best(nt->ga_info, live, num);
+
+   for(i = 0, num = 0; i < nt->num; i++)
+      if(nt->fd[i] >= 0) live[num++] = nt->isl[i];
+
+   return num;
+}
+
+/*----------------------------------------------------------------------------
+| Island i is gone: close its connection; its best still counts, but it no
+| longer keeps the others from converging
+----------------------------------------------------------------------------*/
+NT_lost(nt, i)
+   NT_Ptr nt;
+   int    i;
+{
+   char str[80];
+
+   if(nt->fd[i] < 0) return OK;
+   close(nt->fd[i]);
+   nt->fd[i] = -1;
+   nt->isl[i]->converged = TRUE;
+   nt->isl[i]->num_mut   = 0;
+
+   sprintf(str, "NT_coordinator: lost island %d, going on without it", i+1);
+   UT_warn(str);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Send the message in msg (body already filled in, size bytes)
+----------------------------------------------------------------------------*/
+NT_send(fd, msg, type, island, iter, num, len, size)
+   int  fd;
+   char *msg;
+   int  type, island, iter, num, len, size;
+{
+   NT_Head_Ptr head;
+
+   head = (NT_Head_Ptr)msg;
+   head->type   = type;
+   head->island = island;
+   head->iter   = iter;
+   head->num    = num;
+   head->len    = len;
+
+   return PR_write(fd, msg, (int)sizeof(NT_Head_Type) + size);
+}
+
+/*----------------------------------------------------------------------------
+| Receive a message into msg (of max bytes); ERROR if the connection is gone,
+| the message does not fit or is not of the type expected (any if type < 0)
+----------------------------------------------------------------------------*/
+NT_recv(fd, msg, max, type)
+   int  fd;
+   char *msg;
+   int  max, type;
+{
+   NT_Head_Type head;
+   int          size;
+
+   /*--- Header ---*/
+   if(PR_read(fd, (char *)&head, sizeof(head)) != OK) return ERROR;
+   if(type >= 0 && head.type != type) return ERROR;
+   if(head.num < 0 || head.len < 0 || head.num > 0x100000 ||
+      head.len > 0x1000000) return ERROR;
+
+   /*--- Room for the body? ---*/
+   size = NT_size(head.type, head.num, head.len);
+   if((int)sizeof(head) + size > max) return ERROR;
+
+   /*--- Body ---*/
+   memcpy(msg, (char *)&head, sizeof(head));
+   return PR_read(fd, NT_BODY(msg), size);
+}
+
+/*----------------------------------------------------------------------------
+| Bytes in the body of a message of type with num chromosomes of len genes
+| (only statistics and migrants have a body)
+----------------------------------------------------------------------------*/
+NT_size(type, num, len)
+   int type, num, len;
+{
+   int size;
+
+   if(type != NT_STATS && type != NT_MIGRANTS) return 0;
+   size = num * (len * sizeof(Gene_Type) + sizeof(double));
+   if(type == NT_STATS) size += NT_NUM_STATS * sizeof(double);
+
+   return size;
+}
+
+/*----------------------------------------------------------------------------
+| Copy num chromosomes (genes, then fitness) to buf
+----------------------------------------------------------------------------*/
+NT_put(buf, chrom, num)
+   char      *buf;
+   Chrom_Ptr *chrom;
+   int       num;
+{
+   int i, n;
+
+   for(i = 0; i < num; i++) {
+      n = chrom[i]->length * sizeof(Gene_Type);
+      memcpy(buf, (char *)chrom[i]->gene, n);
+      memcpy(buf + n, (char *)&chrom[i]->fitness, sizeof(double));
+      buf += n + sizeof(double);
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Copy num chromosomes from buf (as written by NT_put())
+----------------------------------------------------------------------------*/
+NT_get(buf, chrom, num)
+   char      *buf;
+   Chrom_Ptr *chrom;
+   int       num;
+{
+   int i, n;
+
+   for(i = 0; i < num; i++) {
+      n = chrom[i]->length * sizeof(Gene_Type);
+      memcpy((char *)chrom[i]->gene, buf, n);
+      memcpy((char *)&chrom[i]->fitness, buf + n, sizeof(double));
+      buf += n + sizeof(double);
+   }
+
+   return OK;
+}
@@ -9,12 +9,18 @@
 |    PL_free()     - deallocate a pool
 |    PL_valid()    - is a pool valid?
 |    PL_reset()    - reset a pool
+|    PL_arena()    - allocate the chroms of a pool at once
+|    PL_arena_pair() - allocate the chroms of two pools at once
+|    PL_new_chrom() - get a chrom for a pool (a spare one if possible)
+|    PL_recycle()  - keep a chrom removed from a pool for reuse
+|    PL_slot()     - chrom in a slot of a pool, made if need be
 |    PL_eval()     - evaluate a pool
 |    PL_get_num()  - get a number
 |    PL_generate() - generate a pool
 |    PL_read()     - read a pool from a file
 |    PL_rand()     - generate a random pool
 |    PL_stats()    - calculate pool statistics
+|    PL_restat()   - update pool statistics after a few changes
 |    PL_index()    - index a pool
 |    PL_update_ptf() - update the percent of total fitness in a pool
 |    PL_clean()    - empty a pool
@@ -23,13 +29,60 @@
 |    PL_remove()   - remove a chrom from a pool
 |    PL_move()     - move a chrom in a pool
 |    PL_swap()     - swap two chroms in a pool
+|    PL_take()     - take a chrom over from another pool
 |    PL_sort()     - sort a pool
+|
+| NOTE: chromosomes removed from a pool are kept as spares, genes and all,
+|       and handed out again by PL_new_chrom() instead of being freed and
+|       allocated anew; they are freed by PL_free().  pool->num_alloc
+|       counts the allocations the pool could not avoid, so once a GA has
+|       warmed up it should stay put.
+|
+| NOTE: pool->fit holds the fitness of every slot, in slot order, and is
+|       kept up to date where it changes: PL_insert(), PL_remove(),
+|       PL_move(), PL_swap(), PL_take(), PL_slot(), PL_sort() and
+|       PL_eval() write it along with the slot, and whoever writes a
+|       chromosome of the pool in place (e.g. CH_copy() or EV_batch() on
+|       pool->chrom) calls PL_FIT() for it.  PL_stats(), PL_restat(),
+|       PL_update_ptf(), PL_sort() and the roulette only read pool->fit
+|       (ptf goes to pool->ptf), never pool->chrom[i].  The reductions of
+|       PL_stats() take four values at a time, with AVX2 or NEON when the
+|       compiler targets them (e.g. -mavx2), else in plain C.
+|
+| NOTE: the functions above also note the slots they change, with their
+|       fitness before and after, so that PL_restat() only has to look at
+|       those (a steady state trial changes two).  A chromosome of the pool
+|       written with PL_FIT() calls for PL_stats().
 ============================================================================*/
 #include "ga.h"
+#include <float.h>
 
-/* Number of chromosome pointers to alloc at a time */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/* Least number of chromosome pointers to add at a time (pools double) */
 #define PL_ALLOC_SIZE 10 
 
+/* Alignment of the gene rows of an arena (a cache line) */
+#define PL_ARENA_ALIGN 64
+
+/* Chromosomes per block of PL_stats() (blocks go to the eval threads) */
+#define PL_BLOCK 65536
+
+/* Least number of changed slots PL_restat() takes one at a time */
+#define PL_CHANGED 64
+
+/*--- One block of PL_stats() ---*/
+typedef struct {
+   Pool_Ptr pool;
+   double   min, max, sum, sum2;      /* As PL_reduce() */
+   int      min_index, max_index;
+   int      same;                     /* All fitness the same? */
+} PL_Block_Type, *PL_Block_Ptr;
+
 /*----------------------------------------------------------------------------
 | Allocate a pool
 ----------------------------------------------------------------------------*/
@@ -50,6 +103,10 @@ Pool_Ptr PL_alloc(max_size)
    pool->chrom = (Chrom_Ptr *)calloc(max_size, sizeof(Chrom_Ptr));
    if(pool->chrom == NULL) UT_error("PL_alloc: chrom alloc failed");
 
+   /*--- And for their fitness ---*/
+   pool->fit = (double *)calloc(max_size, sizeof(double));
+   if(pool->fit == NULL) UT_error("PL_alloc: fit alloc failed");
+
    /*--- Put in magic cookie ---*/
    pool->magic_cookie = PL_cookie;
 
@@ -68,7 +125,7 @@ PL_resize(pool, new_size)
    Pool_Ptr  pool;
    int       new_size;
 {
-   int old_size;
+   int i, old_size;
 
    /*--- Error check ---*/
    if(!PL_valid(pool)) UT_error("PL_resize: invalid pool");
@@ -80,13 +137,19 @@ PL_resize(pool, new_size)
    /*--- Reallocate memory for chromosome pointers ---*/
    pool->chrom = (Chrom_Ptr *)realloc(pool->chrom, new_size*sizeof(Chrom_Ptr));
    if(pool->chrom == NULL) UT_error("PL_resize: chrom realloc failed");
+   pool->fit = (double *)realloc(pool->fit, new_size * sizeof(double));
+   if(pool->fit == NULL) UT_error("PL_resize: fit realloc failed");
+   if(new_size > pool->max_size) pool->num_alloc++;
 
    /*--- Update pool size ---*/
    old_size       = pool->max_size;
    pool->max_size = new_size;
 
-   /*--- Make any new chromosomes NULL ---*/
-   if(new_size > old_size) PL_clean(pool, old_size, new_size);
+   /*--- Make any new chromosomes NULL (realloc leaves them undefined) ---*/
+   for(i = old_size; i < new_size; i++) {
+      pool->chrom[i] = NULL;
+      pool->fit[i]   = 0.0;
+   }
 }
 
 /*----------------------------------------------------------------------------
@@ -109,6 +172,37 @@ void PL_free(pool)
       pool->chrom = NULL;
    }
 
+   /*--- Release the spare chromosomes ---*/
+   while(pool->num_spare > 0) CH_free(pool->spare[--pool->num_spare]);
+   free(pool->spare);
+   pool->spare = NULL;
+
+   /*--- Release fitness, ptf, wheel, sort keys and the tree ---*/
+   free(pool->fit);
+   free(pool->ptf);
+   free(pool->wheel);
+   free(pool->key);
+   free(pool->changed);
+   free(pool->tree);
+   pool->fit     = NULL;
+   pool->ptf     = NULL;
+   pool->wheel   = NULL;
+   pool->key     = NULL;
+   pool->changed = NULL;
+   pool->tree    = NULL;
+
+   /*--- Release the arena (genes only if no other pool shares them) ---*/
+   if(pool->arena != NULL) {
+      free(pool->arena);
+      if(--*pool->arena_refs == 0) {
+         free(pool->arena_gene);
+         free(pool->arena_refs);
+      }
+      pool->arena      = NULL;
+      pool->arena_gene = NULL;
+      pool->arena_refs = NULL;
+   }
+
    /*--- Put in a NULL magic cookie ---*/
    pool->magic_cookie = NL_cookie;
 
@@ -150,6 +244,7 @@ PL_reset(pool)
          CH_reset(pool->chrom[i]);
       else
          pool->chrom[i] = NULL;
+      pool->fit[i] = 0.0;
    }
 
    /*--- Reset pool ---*/
@@ -164,6 +259,216 @@ PL_reset(pool)
    pool->max_index = -1;
    pool->minimize = TRUE;
    pool->sorted   = FALSE;
+   pool->stat_size = -1;
+}
+
+/*----------------------------------------------------------------------------
+| Allocate the chromosomes of a pool at once
+|
+| Every empty slot gets a chromosome of chrom_len genes, stored as store
+| (see CH_store()).  The chromosomes
+| are one array and their genes one matrix, a cache aligned row each (or,
+| for short chromosomes, a power of two bytes, several to a cache line), so
+| going through the pool or copying genes walks memory in order instead of
+| chasing a couple of heap blocks per chromosome.  Chromosomes stay put
+| when they are moved around the pool; only their pointers move.
+|
+| NOTE: a pool has at most one arena, freed by PL_free().  Slots added by
+|       PL_resize() later get chromosomes of their own, as before.
+----------------------------------------------------------------------------*/
+PL_arena(pool, chrom_len, store)
+   Pool_Ptr pool;
+   int      chrom_len, store;
+{
+   return PL_arena_pair(pool, NULL, chrom_len, store);
+}
+
+/*----------------------------------------------------------------------------
+| Allocate the chromosomes of two pools at once (other may be NULL)
+|
+| As PL_arena(), but the genes of both pools are rows of the same matrix,
+| so chromosomes of one pool may take over the genes of the other without
+| copying them (see PL_take()).  Each pool keeps its own chromosomes; the
+| genes are freed with the last of the two pools.
+|
+| NOTE: a pool that already has an arena keeps it and shares nothing.
+----------------------------------------------------------------------------*/
+PL_arena_pair(pool, other, chrom_len, store)
+   Pool_Ptr pool, other;
+   int      chrom_len, store;
+{
+   Pool_Ptr pools[2];
+   int      i, p, n, num[2], total, *refs;
+   size_t   size, row;
+   void     *mem;
+
+   /*--- Error check ---*/
+   if(!PL_valid(pool)) UT_error("PL_arena: invalid pool");
+   if(other != NULL && !PL_valid(other)) UT_error("PL_arena: invalid other");
+   if(chrom_len <= 0) UT_error("PL_arena: invalid chrom_len");
+
+   /*--- Only one arena per pool, and only pools with empty slots ---*/
+   pools[0] = pool;
+   pools[1] = other;
+   for(p = n = total = 0; p < 2; p++) {
+      if(pools[p] == NULL || pools[p]->arena != NULL) continue;
+      for(i = num[n] = 0; i < pools[p]->max_size; i++)
+         if(!CH_valid(pools[p]->chrom[i])) num[n]++;
+      if(num[n] == 0) continue;
+      total += num[n];
+      pools[n++] = pools[p];
+   }
+   if(n == 0) return OK;
+
+   /*--- Rows of whole cache lines, or short ones that never straddle one ---*/
+   size = CH_size(chrom_len, store);
+   for(row = sizeof(double); row < size && row < PL_ARENA_ALIGN; row *= 2)
+      ;
+   if(row < size)
+      row = (size + PL_ARENA_ALIGN - 1) / PL_ARENA_ALIGN * PL_ARENA_ALIGN;
+
+   /*--- Allocate genes, and count the pools sharing them ---*/
+   if(posix_memalign(&mem, PL_ARENA_ALIGN, total * row) != 0)
+      UT_error("PL_arena: gene alloc failed");
+   refs = (int *)malloc(sizeof(int));
+   if(refs == NULL) UT_error("PL_arena: alloc failed");
+   *refs = n;
+
+   /*--- Chromosomes of each pool, in its empty slots ---*/
+   for(p = total = 0; p < n; p++) {
+      pool = pools[p];
+      pool->arena = (Chrom_Ptr)calloc(num[p], sizeof(Chrom_Type));
+      if(pool->arena == NULL) UT_error("PL_arena: chrom alloc failed");
+      pool->arena_gene = (Gene_Ptr)mem;
+      pool->arena_refs = refs;
+
+      for(i = num[p] = 0; i < pool->max_size; i++) {
+         if(CH_valid(pool->chrom[i])) continue;
+         pool->chrom[i] = &pool->arena[num[p]++];
+         pool->chrom[i]->gene   = (Gene_Ptr)((char *)mem + total++ * row);
+         pool->chrom[i]->store  = store;
+         pool->chrom[i]->length = chrom_len;
+         pool->chrom[i]->arena  = row;
+         pool->chrom[i]->magic_cookie = CH_cookie;
+         CH_reset(pool->chrom[i]);
+      }
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Get a chromosome of length genes for a pool: a spare one if there is one
+| (reset, and resized if need be), else a new one
+----------------------------------------------------------------------------*/
+Chrom_Ptr PL_new_chrom(pool, length)
+   Pool_Ptr pool;
+   int      length;
+{
+   Chrom_Ptr chrom;
+
+   /*--- Error check ---*/
+   if(!PL_valid(pool)) UT_error("PL_new_chrom: invalid pool");
+   if(length <= 0) UT_error("PL_new_chrom: invalid length");
+
+   /*--- No spare ---*/
+   if(pool->num_spare == 0) {
+      pool->num_alloc++;
+      return CH_alloc(length);
+   }
+
+   /*--- Reuse the last spare ---*/
+   chrom = pool->spare[--pool->num_spare];
+   if(chrom->length != length) {
+      CH_resize(chrom, length);
+      pool->num_alloc++;
+   } else {
+      CH_reset(chrom);
+   }
+
+   return chrom;
+}
+
+/*----------------------------------------------------------------------------
+| Keep a chromosome removed from a pool for PL_new_chrom() (freed instead
+| if the pool already has as many spares as slots)
+----------------------------------------------------------------------------*/
+PL_recycle(pool, chrom)
+   Pool_Ptr  pool;
+   Chrom_Ptr chrom;
+{
+   /*--- Error check ---*/
+   if(!PL_valid(pool)) UT_error("PL_recycle: invalid pool");
+   if(!CH_valid(chrom)) return OK;
+
+   /*--- A pool never needs more spares than it has slots ---*/
+   if(pool->num_spare >= pool->max_size) {
+      CH_free(chrom);
+      return OK;
+   }
+
+   /*--- Room for one more spare (doubling) ---*/
+   if(pool->num_spare == pool->max_spare) {
+      pool->max_spare = MAX(PL_ALLOC_SIZE, 2 * pool->max_spare);
+      pool->spare = (Chrom_Ptr *)realloc(pool->spare,
+                                         pool->max_spare * sizeof(Chrom_Ptr));
+      if(pool->spare == NULL) UT_error("PL_recycle: spare realloc failed");
+      pool->num_alloc++;
+   }
+
+   pool->spare[pool->num_spare++] = chrom;
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Slot index of pool has just been written: its fitness into pool->fit, and
+| note the change since the last statistics (past max_changed only the
+| count goes on, up to one more: too many to note)
+----------------------------------------------------------------------------*/
+static void PL_changed(pool, index)
+   Pool_Ptr pool;
+   int      index;
+{
+   Change_Ptr change = NULL;
+
+   if(pool->num_changed < pool->max_changed) {
+      change        = pool->changed + pool->num_changed;
+      change->index = index;
+      change->was   = pool->fit[index];
+   }
+
+   /*--- An empty slot keeps the fitness it had ---*/
+   if(CH_valid(pool->chrom[index])) PL_FIT(pool, index);
+
+   if(change != NULL) change->now = pool->fit[index];
+   if(pool->num_changed <= pool->max_changed) pool->num_changed++;
+}
+
+/*----------------------------------------------------------------------------
+| The chromosome in slot index of pool, for writing into it in place (e.g.
+| children that will be appended); the pool grows and the slot gets a
+| chromosome of length genes if need be
+----------------------------------------------------------------------------*/
+Chrom_Ptr PL_slot(pool, index, length)
+   Pool_Ptr pool;
+   int      index, length;
+{
+   /*--- Error check ---*/
+   if(!PL_valid(pool)) UT_error("PL_slot: invalid pool");
+   if(index < 0) UT_error("PL_slot: invalid index");
+
+   /*--- Grow the pool (doubling) ---*/
+   if(index >= pool->max_size)
+      PL_resize(pool, MAX(index + 1, pool->max_size + 
+                                     MAX(PL_ALLOC_SIZE, pool->max_size)));
+
+   /*--- Make sure there is a chromosome ---*/
+   if(!CH_valid(pool->chrom[index])) {
+      pool->chrom[index] = PL_new_chrom(pool, length);
+      PL_changed(pool, index);
+   }
+
+   return pool->chrom[index];
 }
 
 /*----------------------------------------------------------------------------
@@ -180,21 +485,23 @@ PL_eval(ga_info, pool)
    if(!PL_valid(pool)) UT_error("PL_eval: invalid pool");
 
    /*--- Evaluate each chromosome ---*/
-   for(i = 0; i < pool->size; i++) {
-      ga_info->EV_fun(pool->chrom[i]);
-   }
+   EV_batch(ga_info, pool->chrom, pool->size);
+
+   /*--- Every slot has changed ---*/
+   for(i = 0; i < pool->size; i++) PL_FIT(pool, i);
+   pool->stat_size = -1;
 }
 
 /*============================================================================
 |                            Generate pool
 ============================================================================*/
 /*----------------------------------------------------------------------------
-| Read a number for PL_generate()
+| Read a number for PL_generate() into str (at least 80 chars)
 ----------------------------------------------------------------------------*/
-char *PL_get_num(fid)
+char *PL_get_num(fid, str)
    FILE   *fid;
+   char   *str;
 {
-   static char str[80]; /* This MUST be static */
    int  ch, len = 0;
 
    /*--- Search for a digit ---*/
@@ -219,7 +526,7 @@ char *PL_get_num(fid)
    if(!isdigit(ch)) UT_error("PL_get_num: bad digit");
 
    /*--- Digit found, now put into str ---*/
-   while(len < 80 && ch != EOF && !isspace(ch) && ch != '#') {
+   while(len < 79 && ch != EOF && !isspace(ch) && ch != '#') {
       str[len++] = ch;
       ch = fgetc(fid);
    }
@@ -229,6 +536,185 @@ char *PL_get_num(fid)
    return str;
 }
 
+/*----------------------------------------------------------------------------
+| Make sure pool->ptf, wheel and key have room for the pool
+----------------------------------------------------------------------------*/
+static void PL_room(pool)
+   Pool_Ptr pool;
+{
+   if(pool->max_fit >= pool->size) return;
+
+   pool->max_fit = pool->max_size;
+   pool->ptf = (float *)realloc(pool->ptf, pool->max_fit * sizeof(float));
+   pool->wheel = (Wheel_Ptr)realloc(pool->wheel, 
+                                    pool->max_fit * sizeof(Wheel_Type));
+   pool->key = (Sort_Key_Ptr)realloc(pool->key, 
+                                     pool->max_fit * sizeof(Sort_Key_Type));
+   if(pool->ptf == NULL || pool->wheel == NULL || pool->key == NULL)
+      UT_error("PL_room: alloc failed");
+   pool->num_alloc++;
+}
+
+/*----------------------------------------------------------------------------
+| Min and max (first index of each), sum and sum of squares of num > 0
+| fitness values
+|
+| Value i goes to lane i%4 of four, so vectors of four doubles (AVX2, or
+| two pairs with NEON) do the work; the lanes are added up in the same
+| order whatever the build, so the results do not depend on it.  Squares
+| are taken in single precision, as they always have been here.
+----------------------------------------------------------------------------*/
+static void PL_reduce(fit, num, min, min_index, max, max_index, sum, sum2)
+   double *fit, *min, *max, *sum, *sum2;
+   int    num, *min_index, *max_index;
+{
+   double lmin[4], lmax[4], lmin_i[4], lmax_i[4], lsum[4], lsum2[4];
+   float  h;
+   int    i, j;
+
+   /*--- Every lane starts from the first value, like a plain loop ---*/
+   for(j = 0; j < 4; j++) {
+      lmin[j]   = lmax[j]   = fit[0];
+      lmin_i[j] = lmax_i[j] = 0.0;
+      lsum[j]   = lsum2[j]  = 0.0;
+   }
+   i = 0;
+
+#if defined(__AVX2__)
+   {
+      __m256d vmin, vmax, vmin_i, vmax_i, vsum, vsum2, vi, f, lt, gt;
+      __m128  f4;
+
+      vmin   = _mm256_loadu_pd(lmin);
+      vmax   = _mm256_loadu_pd(lmax);
+      vmin_i = vmax_i = vsum = vsum2 = _mm256_setzero_pd();
+      vi     = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+      for( ; i + 4 <= num; i += 4) {
+         f      = _mm256_loadu_pd(fit + i);
+         lt     = _mm256_cmp_pd(f, vmin, _CMP_LT_OQ);
+         gt     = _mm256_cmp_pd(f, vmax, _CMP_GT_OQ);
+         vmin   = _mm256_blendv_pd(vmin, f, lt);
+         vmin_i = _mm256_blendv_pd(vmin_i, vi, lt);
+         vmax   = _mm256_blendv_pd(vmax, f, gt);
+         vmax_i = _mm256_blendv_pd(vmax_i, vi, gt);
+         vsum   = _mm256_add_pd(vsum, f);
+         f4     = _mm256_cvtpd_ps(f);
+         vsum2  = _mm256_add_pd(vsum2, _mm256_cvtps_pd(_mm_mul_ps(f4, f4)));
+         vi     = _mm256_add_pd(vi, _mm256_set1_pd(4.0));
+      }
+      _mm256_storeu_pd(lmin, vmin);
+      _mm256_storeu_pd(lmax, vmax);
+      _mm256_storeu_pd(lmin_i, vmin_i);
+      _mm256_storeu_pd(lmax_i, vmax_i);
+      _mm256_storeu_pd(lsum, vsum);
+      _mm256_storeu_pd(lsum2, vsum2);
+   }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+   {
+      float64x2_t vmin[2], vmax[2], vmin_i[2], vmax_i[2], vsum[2], vsum2[2];
+      float64x2_t vi[2], f;
+      float32x2_t f2;
+      uint64x2_t  lt, gt;
+      int         k;
+
+      for(k = 0; k < 2; k++) {
+         vmin[k]   = vld1q_f64(lmin + 2*k);
+         vmax[k]   = vld1q_f64(lmax + 2*k);
+         vmin_i[k] = vmax_i[k] = vsum[k] = vsum2[k] = vdupq_n_f64(0.0);
+         vi[k]     = vcombine_f64(vdup_n_f64(2.0*k), vdup_n_f64(2.0*k + 1.0));
+      }
+      for( ; i + 4 <= num; i += 4) {
+         for(k = 0; k < 2; k++) {
+            f         = vld1q_f64(fit + i + 2*k);
+            lt        = vcltq_f64(f, vmin[k]);
+            gt        = vcgtq_f64(f, vmax[k]);
+            vmin[k]   = vbslq_f64(lt, f, vmin[k]);
+            vmin_i[k] = vbslq_f64(lt, vi[k], vmin_i[k]);
+            vmax[k]   = vbslq_f64(gt, f, vmax[k]);
+            vmax_i[k] = vbslq_f64(gt, vi[k], vmax_i[k]);
+            vsum[k]   = vaddq_f64(vsum[k], f);
+            f2        = vcvt_f32_f64(f);
+            vsum2[k]  = vaddq_f64(vsum2[k], vcvt_f64_f32(vmul_f32(f2, f2)));
+            vi[k]     = vaddq_f64(vi[k], vdupq_n_f64(4.0));
+         }
+      }
+      for(k = 0; k < 2; k++) {
+         vst1q_f64(lmin + 2*k, vmin[k]);
+         vst1q_f64(lmax + 2*k, vmax[k]);
+         vst1q_f64(lmin_i + 2*k, vmin_i[k]);
+         vst1q_f64(lmax_i + 2*k, vmax_i[k]);
+         vst1q_f64(lsum + 2*k, vsum[k]);
+         vst1q_f64(lsum2 + 2*k, vsum2[k]);
+      }
+   }
+#endif
+
+   /*--- The rest (or all of them, in plain C) ---*/
+   for( ; i < num; i++) {
+      j = i & 3;
+      if(fit[i] < lmin[j]) {
+         lmin[j]   = fit[i];
+         lmin_i[j] = i;
+      }
+      if(fit[i] > lmax[j]) {
+         lmax[j]   = fit[i];
+         lmax_i[j] = i;
+      }
+      lsum[j]  += fit[i];
+      h         = (float)fit[i];
+      lsum2[j] += h * h;
+   }
+
+   /*--- Lanes together (on a tie, the first index wins) ---*/
+   *min  = lmin[0];  *min_index = (int)lmin_i[0];
+   *max  = lmax[0];  *max_index = (int)lmax_i[0];
+   *sum  = lsum[0];
+   *sum2 = lsum2[0];
+   for(j = 1; j < 4; j++) {
+      if(lmin[j] < *min || (lmin[j] == *min && lmin_i[j] < *min_index)) {
+         *min       = lmin[j];
+         *min_index = (int)lmin_i[j];
+      }
+      if(lmax[j] > *max || (lmax[j] == *max && lmax_i[j] < *max_index)) {
+         *max       = lmax[j];
+         *max_index = (int)lmax_i[j];
+      }
+      *sum  += lsum[j];
+      *sum2 += lsum2[j];
+   }
+}
+
+/*----------------------------------------------------------------------------
+| Block b of PL_stats() (arg is the array of blocks): PL_reduce() of its
+| slots of pool->fit
+----------------------------------------------------------------------------*/
+static void PL_block(arg, b, id)
+   void *arg;
+   int  b, id;
+{
+   PL_Block_Ptr blk;
+   Pool_Ptr     pool;
+   double       *fit;
+   int          i, first, last;
+
+   blk   = (PL_Block_Ptr)arg + b;
+   pool  = blk->pool;
+   fit   = pool->fit;
+   first = b * PL_BLOCK;
+   last  = MIN(pool->size, first + PL_BLOCK);
+
+   /*--- Check for variance in fitness ---*/
+   blk->same = TRUE;
+   for(i = first + 1; i < last && blk->same; i++)
+      if(fit[i] != fit[first]) blk->same = FALSE;
+
+   /*--- The rest ---*/
+   PL_reduce(fit + first, last - first, &blk->min, &blk->min_index,
+             &blk->max, &blk->max_index, &blk->sum, &blk->sum2);
+   blk->min_index += first;
+   blk->max_index += first;
+}
+
 /*----------------------------------------------------------------------------
 | Generate pool according to ga_info->ip_flag:
 |
@@ -244,7 +730,7 @@ PL_generate(ga_info, pool)
 {
    FILE *fid;
    long chrom_len;
-   char *sptr;
+   char *sptr, str[80];
 
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("PL_generate: invalid ga_info");
@@ -257,7 +743,7 @@ PL_generate(ga_info, pool)
 
          /*--- Get chrom_len ---*/
          puts("\nEnter chromosome length:");
-         if((sptr = PL_get_num(stdin)) == NULL) {
+         if((sptr = PL_get_num(stdin, str)) == NULL) {
             UT_error("PL_generate: No chrom_len was read");
          }
          if(sscanf(sptr,"%ld",&chrom_len) != 1) 
@@ -279,7 +765,7 @@ PL_generate(ga_info, pool)
             UT_error("PL_generate: Invalid data file");
 
          /*--- Get chrom_len ---*/
-         if((sptr = PL_get_num(fid)) == NULL) {
+         if((sptr = PL_get_num(fid, str)) == NULL) {
             UT_error("PL_generate: No chrom_len was read");
          }
          if(sscanf(sptr,"%ld",&chrom_len) != 1) 
@@ -296,12 +782,12 @@ PL_generate(ga_info, pool)
          break;
 
       case IP_RANDOM:
-         PL_rand(pool, ga_info->pool_size, ga_info->chrom_len, 
-                    ga_info->datatype);
+         PL_rand(&ga_info->rn, pool, ga_info->pool_size, 
+                 ga_info->chrom_len, ga_info->datatype);
          break;
       case IP_RANDOM01:
-         PL_rand01(pool, ga_info->pool_size, ga_info->chrom_len, 
-                    ga_info->datatype);
+         PL_rand01(&ga_info->rn, pool, ga_info->pool_size, 
+                   ga_info->chrom_len, ga_info->datatype);
          break;
 
       case IP_NONE:
@@ -329,7 +815,7 @@ int PL_read(pool, chrom_len, fid)
    Chrom_Ptr  chrom;
    double     gene;
    long       i;
-   char       *sptr;
+   char       *sptr, str[80];
 
    /*--- Error check ---*/
    if(!PL_valid(pool)) UT_error("PL_read: invalid pool");
@@ -345,20 +831,20 @@ int PL_read(pool, chrom_len, fid)
          CH_resize(chrom, chrom_len);
          pool->chrom[pool->size] = NULL;
       } else {
-         chrom = CH_alloc(chrom_len);
+         chrom = PL_new_chrom(pool, chrom_len);
       }
 
       /*--- Read genes ---*/
       for(i=0; i < chrom_len; i++) {
 
          /*--- Read a gene ---*/
-         sptr = PL_get_num(fid);
+         sptr = PL_get_num(fid, str);
 
          /*--- Get number from sptr if valid ---*/
          if(sptr == NULL || sscanf(sptr,"%lf",&gene) != 1) {
 
-            /*--- Free chromosome ---*/
-            CH_free(chrom);
+            /*--- Keep chromosome for reuse ---*/
+            PL_recycle(pool, chrom);
 
             /*--- EOF in middle of chromosome ---*/
             if(i != 0 && (sptr == NULL || *sptr != 'q')) {
@@ -385,7 +871,8 @@ int PL_read(pool, chrom_len, fid)
 |       arbitrarily chosen domain.  There really needs to be a way for
 |       the user to indicate a domain for EACH gene.
 ----------------------------------------------------------------------------*/
-PL_rand(pool, pool_size, chrom_len, datatype) 
+PL_rand(rn, pool, pool_size, chrom_len, datatype) 
+   RN_Ptr   rn;
    Pool_Ptr pool;
    int      pool_size, chrom_len, datatype;
 {
@@ -417,35 +904,37 @@ PL_rand(pool, pool_size, chrom_len, datatype)
          CH_resize(chrom, chrom_len);
          pool->chrom[pool->size] = NULL;
       } else {
-         chrom = CH_alloc(chrom_len);
+         chrom = PL_new_chrom(pool, chrom_len);
       }
 
       /*--- Generate random genes ---*/
       switch(datatype) {
 
          case DT_BIT:
-            /*--- Random bit ---*/
-            for(j = 0; j < chrom_len; j++)
-               chrom->gene[j] = (Gene_Type)RAND_BIT();
+            /*--- Random bit (same bits when packed) ---*/
+            if(chrom->store == ST_BITS)
+               RN_fill_words(rn, chrom->word, chrom_len);
+            else
+               RN_fill_bits(rn, chrom->gene, chrom_len);
             chrom->length = chrom_len;
             break;
 
          case DT_INT:
             /*--- Random integers from an arbitrary domain ---*/
             for(j = 0; j < chrom_len; j++)
-               chrom->gene[j] = (Gene_Type)RAND_DOM(0,chrom_len);
+               CH_SET_INT(chrom, j, RN_dom(rn, 0,chrom_len));
             chrom->length = chrom_len;
             break;
 
          case DT_INT_PERM:
             /*--- Random permutations of integers ---*/
             for(j = 0; j < chrom_len; j++) 
-               chrom->gene[j] = (Gene_Type)-1;
+               CH_SET_INT(chrom, j, -1);
             for(j = 0; j < chrom_len; j++) {
-               idx = RAND_DOM(0,chrom_len-1);
-               while(chrom->gene[idx] != -1) 
-                  idx = RAND_DOM(0,chrom_len-1);
-               chrom->gene[idx] = (Gene_Type)(j + 1);
+               idx = RN_dom(rn, 0,chrom_len-1);
+               while(CH_INT(chrom, idx) != -1) 
+                  idx = RN_dom(rn, 0,chrom_len-1);
+               CH_SET_INT(chrom, idx, j + 1);
             }
             chrom->length = chrom_len;
             break;
@@ -453,8 +942,8 @@ PL_rand(pool, pool_size, chrom_len, datatype)
          case DT_REAL:
             /*--- Random reals from an arbitrary domain ---*/
             for(j = 0; j < chrom_len; j++)
-               chrom->gene[j] = 
-                  (double)RAND_DOM(0,chrom_len-1) + (double)RAND_FRAC();
+               CH_SET_REAL(chrom, j,
+                  (double)RN_dom(rn, 0,chrom_len-1) + (double)RN_frac(rn));
             chrom->length = chrom_len;
             break;
 
@@ -469,7 +958,8 @@ PL_rand(pool, pool_size, chrom_len, datatype)
 /*----------------------------------------------------------------------------
 | Initialize random pool in [0,1].
 ----------------------------------------------------------------------------*/
-PL_rand01(pool, pool_size, chrom_len, datatype) 
+PL_rand01(rn, pool, pool_size, chrom_len, datatype) 
+   RN_Ptr   rn;
    Pool_Ptr pool;
    int      pool_size, chrom_len, datatype;
 {
@@ -501,43 +991,47 @@ PL_rand01(pool, pool_size, chrom_len, datatype)
          CH_resize(chrom, chrom_len);
          pool->chrom[pool->size] = NULL;
       } else {
-         chrom = CH_alloc(chrom_len);
+         chrom = PL_new_chrom(pool, chrom_len);
       }
 
       /*--- Generate random genes ---*/
       switch(datatype) {
 
          case DT_BIT:
-            /*--- Random bit ---*/
-            for(j = 0; j < chrom_len; j++)
-               chrom->gene[j] = (Gene_Type)RAND_BIT();
+            /*--- Random bit (same bits when packed) ---*/
+            if(chrom->store == ST_BITS)
+               RN_fill_words(rn, chrom->word, chrom_len);
+            else
+               RN_fill_bits(rn, chrom->gene, chrom_len);
             chrom->length = chrom_len;
             break;
 
          case DT_INT:
             /*--- Random integers from an arbitrary domain ---*/
             for(j = 0; j < chrom_len; j++)
-               chrom->gene[j] = (Gene_Type)RAND_DOM(0,chrom_len);
+               CH_SET_INT(chrom, j, RN_dom(rn, 0,chrom_len));
             chrom->length = chrom_len;
             break;
 
          case DT_INT_PERM:
             /*--- Random permutations of integers ---*/
             for(j = 0; j < chrom_len; j++) 
-               chrom->gene[j] = (Gene_Type)-1;
+               CH_SET_INT(chrom, j, -1);
             for(j = 0; j < chrom_len; j++) {
-               idx = RAND_DOM(0,chrom_len-1);
-               while(chrom->gene[idx] != -1) 
-                  idx = RAND_DOM(0,chrom_len-1);
-               chrom->gene[idx] = (Gene_Type)(j + 1);
+               idx = RN_dom(rn, 0,chrom_len-1);
+               while(CH_INT(chrom, idx) != -1) 
+                  idx = RN_dom(rn, 0,chrom_len-1);
+               CH_SET_INT(chrom, idx, j + 1);
             }
             chrom->length = chrom_len;
             break;
 
          case DT_REAL:
             /*--- Random reals from an arbitrary domain ---*/
-            for(j = 0; j < chrom_len; j++)
-               chrom->gene[j] =  (double)RAND_FRAC();
+            if(chrom->store == ST_FLOAT)
+               RN_fill_fracf(rn, chrom->f32, chrom_len);
+            else
+               RN_fill_frac(rn, chrom->gene, chrom_len);
             chrom->length = chrom_len;
             break;
 
@@ -555,19 +1049,28 @@ PL_rand01(pool, pool_size, chrom_len, datatype)
 ============================================================================*/
 /*----------------------------------------------------------------------------
 | Compute statistics for a pool
+|
+| Large pools are done PL_BLOCK chromosomes at a time, on the evaluation
+| threads if there are any; blocks are put together in order, so the
+| statistics do not depend on the number of threads.
 ----------------------------------------------------------------------------*/
 PL_stats(ga_info, pool)
    GA_Info_Ptr ga_info;
    Pool_Ptr    pool;
 {
-   unsigned i, min_index, max_index;
-   double   min, max, total, var;
-   int      no_variance, sorted;
+   PL_Block_Type one;
+   PL_Block_Ptr  blk;
+   int           b, num, min_index, max_index, no_variance;
+   double        min, max, total, var;
 
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("PL_stats: invalid ga_info");
    if(!PL_valid(pool)) UT_error("PL_stats: invalid pool");
 
+   /*--- Changes noted so far are taken care of (PL_restat() starts over) ---*/
+   pool->stat_size   = -1;
+   pool->num_changed = 0;
+   pool->num_restat  = 0;
 
    /*--- Trivial cases ---*/
    if(pool->size <= 0) {
@@ -582,74 +1085,55 @@ PL_stats(ga_info, pool)
       pool->best_index    = -1;
       return OK;
    } else if(pool->size == 1) {
-      pool->min           = pool->chrom[0]->fitness;
-      pool->max           = pool->chrom[0]->fitness;
-      pool->ave           = pool->chrom[0]->fitness;
+      pool->min           = pool->fit[0];
+      pool->max           = pool->fit[0];
+      pool->ave           = pool->fit[0];
       pool->var           = 0.0;
       pool->dev           = 0.0;
-      pool->total_fitness = pool->chrom[0]->fitness;
+      pool->total_fitness = pool->fit[0];
       pool->min_index     = 0;
       pool->max_index     = 0;
       pool->best_index    = 0;
       return OK;
    }
 
-   /*--- Initialize stats ---*/
-   min         = pool->chrom[0]->fitness;
-   max         = pool->chrom[0]->fitness;
-   min_index   = 0;
-   max_index   = 0;
-   var         = 0.0;
-   total       = 0.0;
-   no_variance = TRUE;
-   sorted      = TRUE;
-
-   /*--- Collect statistics and find total fitness ---*/
-   for(i = 0; i < pool->size; i++) {
-
-      /*--- Error check ---*/
-      if(!CH_valid(pool->chrom[i])) UT_error("PL_stats: invalid chrom");
-
-      /*--- Comparative statistics ---*/
-      if(i != 0) {
-
-         /*--- Check for variance in fitness ---*/
-         if(no_variance && 
-            pool->chrom[i]->fitness != pool->chrom[i-1]->fitness)
-         {
-            no_variance = FALSE;
-         }
+   /*--- Blocks of the pool ---*/
+   num = (pool->size + PL_BLOCK - 1) / PL_BLOCK;
+   if(num == 1) {
+      blk = &one;
+   } else {
+      blk = (PL_Block_Ptr)malloc(num * sizeof(PL_Block_Type));
+      if(blk == NULL) UT_error("PL_stats: alloc failed");
+   }
+   for(b = 0; b < num; b++) blk[b].pool = pool;
 
-         /*--- Check for not sorted ---*/
-         if(sorted && pool->minimize) {
-            if(pool->chrom[i]->fitness < pool->chrom[i-1]->fitness)
-               sorted = FALSE;
-         } else if(sorted) {
-            if(pool->chrom[i]->fitness > pool->chrom[i-1]->fitness)
-               sorted = FALSE;
-         }
+   /*--- Min, max, total fitness and sum of squares of each ---*/
+   if(num > 1 && TH_valid(ga_info->th_pool))
+      TH_run(ga_info->th_pool, PL_block, (void *)blk, num);
+   else
+      for(b = 0; b < num; b++) PL_block((void *)blk, b, 0);
+
+   /*--- Then of the pool, block after block ---*/
+   min   = blk[0].min;  min_index = blk[0].min_index;
+   max   = blk[0].max;  max_index = blk[0].max_index;
+   total = blk[0].sum;
+   var   = blk[0].sum2;
+   no_variance = blk[0].same;
+   for(b = 1; b < num; b++) {
+      if(blk[b].min < min) {
+         min       = blk[b].min;
+         min_index = blk[b].min_index;
       }
-
-      /*--- Less than min? ---*/
-      if(pool->chrom[i]->fitness < min) {
-         min = pool->chrom[i]->fitness;
-         min_index = i;
+      if(blk[b].max > max) {
+         max       = blk[b].max;
+         max_index = blk[b].max_index;
       }
-
-      /*--- Greater than max? ---*/
-      if(pool->chrom[i]->fitness > max) {
-         max = pool->chrom[i]->fitness;
-         max_index = i;
-      }
-
-      /*--- Update cum. values ---*/
-      total += pool->chrom[i]->fitness;
-      var   += (float)pool->chrom[i]->fitness * 
-               (float)pool->chrom[i]->fitness;
-
-      /*--- Make sure index is set ---*/
-      pool->chrom[i]->index = i;
+      total += blk[b].sum;
+      var   += blk[b].sum2;
+      if(!blk[b].same || pool->fit[b * PL_BLOCK] != pool->fit[0])
+         no_variance = FALSE;
    }
+   if(blk != &one) free(blk);
 
    /*--- Update pool statistics ---*/
    pool->min = min;
@@ -674,6 +1158,164 @@ PL_stats(ga_info, pool)
    }
 }
 
+/*----------------------------------------------------------------------------
+| Node k of the tree of min and max slots from its children (the lower slot
+| on ties, as PL_stats() does)
+----------------------------------------------------------------------------*/
+static void PL_node(pool, k)
+   Pool_Ptr pool;
+   int      k;
+{
+   int    *tree = pool->tree;
+   double *fit  = pool->fit;
+   int    a, b;
+
+   /*--- Min ---*/
+   a = tree[4*k];      b = tree[4*k + 2];
+   tree[2*k] = (a < 0 || (b >= 0 && fit[b] < fit[a])) ? b : a;
+
+   /*--- Max ---*/
+   a = tree[4*k + 1];  b = tree[4*k + 3];
+   tree[2*k + 1] = (a < 0 || (b >= 0 && fit[b] > fit[a])) ? b : a;
+}
+
+/*----------------------------------------------------------------------------
+| Slot index of pool into the tree, then the nodes above it
+----------------------------------------------------------------------------*/
+static void PL_leaf(pool, index)
+   Pool_Ptr pool;
+   int      index;
+{
+   int k;
+
+   k = pool->tree_size + index;
+   pool->tree[2*k] = pool->tree[2*k + 1] = index;
+   for(k /= 2; k >= 1; k /= 2) PL_node(pool, k);
+}
+
+/*----------------------------------------------------------------------------
+| Start PL_restat() over from the statistics just done by PL_stats(): the
+| tree of min and max slots (node k at tree[2k] and tree[2k+1], leaves from
+| tree_size on, -1 for no slot), the mean and the sum of squared deviations
+----------------------------------------------------------------------------*/
+static void PL_tree(pool)
+   Pool_Ptr pool;
+{
+   int    i, k, num;
+   double d, m2;
+
+   /*--- Room for twice the leaves, and a log to match ---*/
+   for(num = 1; num < pool->size; num *= 2);
+   if(num > pool->tree_size) {
+      pool->tree = (int *)realloc(pool->tree, 4 * num * sizeof(int));
+      pool->max_changed = MAX(PL_CHANGED, num / 16);
+      pool->changed = (Change_Ptr)realloc(pool->changed, 
+                                     pool->max_changed * sizeof(Change_Type));
+      if(pool->tree == NULL || pool->changed == NULL)
+         UT_error("PL_tree: alloc failed");
+      pool->tree_size = num;
+      pool->num_alloc++;
+   }
+
+   /*--- Leaves, then the nodes up to the root ---*/
+   num = pool->tree_size;
+   for(i = 0; i < num; i++)
+      pool->tree[2*(num + i)] = pool->tree[2*(num + i) + 1] =
+         i < pool->size ? i : -1;
+   for(k = num - 1; k >= 1; k--) PL_node(pool, k);
+
+   /*--- Squared deviations from the mean (fit[] is up to date) ---*/
+   m2 = 0.0;
+   for(i = 0; i < pool->size; i++) {
+      d   = pool->fit[i] - pool->ave;
+      m2 += d * d;
+   }
+   pool->mean      = pool->ave;
+   pool->m2        = m2;
+   pool->stat_size = pool->size;
+}
+
+/*----------------------------------------------------------------------------
+| Update the statistics of a pool after a few changes (see PL_changed())
+|
+| Only the slots changed since the last statistics are looked at: the mean
+| and the squared deviations are updated a value at a time (Welford) and
+| the min and max come from the tree of PL_tree().  Falls back to PL_stats()
+| when too much has changed, and once the changes add up to the pool size,
+| so rounding does not build up.
+----------------------------------------------------------------------------*/
+PL_restat(ga_info, pool)
+   GA_Info_Ptr ga_info;
+   Pool_Ptr    pool;
+{
+   int    i, j, n;
+   double x, y, mean, var;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("PL_restat: invalid ga_info");
+   if(!PL_valid(pool)) UT_error("PL_restat: invalid pool");
+
+   /*--- Start over? ---*/
+   if(pool->stat_size < 0 || pool->num_changed > pool->max_changed ||
+      pool->size < pool->stat_size || pool->size <= 1 ||
+      pool->size > pool->tree_size || 
+      pool->num_restat + pool->num_changed > pool->size)
+   {
+      PL_stats(ga_info, pool);
+      if(pool->size > 1) PL_tree(pool);
+      return OK;
+   }
+
+   /*--- Changed slots, one change at a time ---*/
+   n = pool->stat_size;
+   for(j = 0; j < pool->num_changed; j++) {
+      i = pool->changed[j].index;
+      if(i >= n) continue;
+      y    = pool->changed[j].was;
+      x    = pool->changed[j].now;
+      mean = pool->mean + (x - y) / n;
+      pool->m2  += (x - y) * ((x - mean) + (y - pool->mean));
+      pool->mean = mean;
+      PL_leaf(pool, i);
+   }
+
+   /*--- New slots ---*/
+   for(i = n; i < pool->size; i++) {
+      x    = pool->fit[i];
+      mean = pool->mean + (x - pool->mean) / (i + 1);
+      pool->m2  += (x - pool->mean) * (x - mean);
+      pool->mean = mean;
+      PL_leaf(pool, i);
+   }
+   pool->num_restat += pool->num_changed + pool->size - n;
+   pool->num_changed = 0;
+   pool->stat_size   = pool->size;
+
+   /*--- Update pool statistics ---*/
+   pool->min_index = pool->tree[2];
+   pool->max_index = pool->tree[3];
+   pool->min = pool->fit[pool->min_index];
+   pool->max = pool->fit[pool->max_index];
+   pool->ave = pool->mean;
+   if(pool->minimize) pool->best_index = pool->min_index;
+   else               pool->best_index = pool->max_index;
+   pool->total_fitness = pool->mean * pool->size;
+
+   /*--- Variance and standard deviation ---*/
+   var = pool->m2 / (pool->size - 1);
+   if(pool->min == pool->max || var <= 0.0) {
+      pool->var = 0.0;
+      pool->dev = 0.0;
+      ga_info->converged = TRUE;
+   } else {
+      pool->var = var;
+      pool->dev = sqrt(var);
+      ga_info->converged = FALSE;
+   }
+
+   return OK;
+}
+
 /*----------------------------------------------------------------------------
 | Update indices in the pool
 ----------------------------------------------------------------------------*/
@@ -691,36 +1333,115 @@ PL_index(pool)
 }
 
 /*----------------------------------------------------------------------------
-| Update ptf (percent of total fitness) for each chromosome
+| Walker's alias table of a roulette wheel with num > 0 slices of width
+| w[i] (in wheel[i].cut on entry): a spin lands on slot j = (int)(u * num)
+| with u in [0..1), and keeps it if the rest of u * num is below
+| wheel[j].cut, else takes wheel[j].alias (see SE_roulette()).
+|
+| Slots come out in slot order: the next short one (below the average) is
+| topped up from the next tall one, and a tall one that ends up short is
+| seen to at once if its turn has gone by.  Slots left over by round off
+| are kept whole.
+----------------------------------------------------------------------------*/
+static void PL_wheel(wheel, num)
+   Wheel_Ptr wheel;
+   int       num;
+{
+   double total, scale;
+   int    i, s, t, next;
+
+   /*--- Widths that make up the average slot (1.0) ---*/
+   for(i = 0, total = 0.0; i < num; i++) {
+      if(!(wheel[i].cut > 0.0)) wheel[i].cut = 0.0;
+      total += wheel[i].cut;
+      wheel[i].alias = i;
+   }
+
+   /*--- No widths to go by: every slot alike ---*/
+   if(!(total > 0.0) || total > DBL_MAX) {
+      for(i = 0; i < num; i++) wheel[i].cut = 1.0;
+      return;
+   }
+   scale = num / total;
+   for(i = 0; i < num; i++) wheel[i].cut *= scale;
+
+   /*--- Top up short slots from tall ones ---*/
+   next = -1;
+   for(s = 0, t = 0; ; ) {
+
+      /*--- Short slot: a tall one gone short, else the next one ---*/
+      if(next >= 0) {
+         i = next;
+         next = -1;
+      } else {
+         for( ; s < num && wheel[s].cut >= 1.0; s++)
+            ;
+         if((i = s++) >= num) break;
+      }
+
+      /*--- Tall slot ---*/
+      for( ; t < num && wheel[t].cut < 1.0; t++)
+         ;
+      if(t >= num) break;
+
+      /*--- Short slot i gets the rest from t ---*/
+      wheel[i].alias = t;
+      wheel[t].cut  -= 1.0 - wheel[i].cut;
+      if(wheel[t].cut < 1.0) {
+         if(t < s) next = t;
+         t++;
+      }
+   }
+
+   /*--- Round off: slots not topped up are kept whole ---*/
+   for(i = 0; i < num; i++)
+      if(wheel[i].alias == i) wheel[i].cut = 1.0;
+}
+
+/*----------------------------------------------------------------------------
+| Update ptf (percent of total fitness) for each chromosome, and the
+| roulette wheel
+|
+| NOTE: the wheel is an alias table (see PL_wheel()), worked out in double
+|       once for all the spins until the pool changes, so each spin is
+|       O(1).  The slice of a chromosome is its scaled fitness (maximize)
+|       or the inverse of it (minimize), in proportion to its ptf.
 ----------------------------------------------------------------------------*/
 PL_update_ptf(ga_info, pool) 
    GA_Info_Ptr ga_info;
    Pool_Ptr    pool;
 {
-   int i, sf_changed, all_positive;
+   int       i, sf_changed, all_positive;
+   double    *fit;
+   float     *ptf;
+   Wheel_Ptr wheel;
 
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("PL_update_ptf: invalid ga_info");
    if(!PL_valid(pool)) UT_error("PL_update_ptf: invalid pool");
 
+   /*--- Fitness in a row (up to date) ---*/
+   PL_room(pool);
+   fit = pool->fit;
+   ptf = pool->ptf;
+
    /*--- Compute scale factor (to ensure positive fitness) ---*/
    sf_changed = FALSE;
    all_positive = TRUE;
    for(i = 0; i < pool->size; i++) {
 
       /*--- If scaled fitness not positive ---*/
-      if((pool->chrom[i]->fitness + ga_info->scale_factor) <= 0) {
+      if((fit[i] + ga_info->scale_factor) <= 0) {
 
          /*--- Adjust scale_factor so scaled fitness is 1.0 ---*/
-         ga_info->scale_factor += 
-            1.0 - (pool->chrom[i]->fitness + ga_info->scale_factor);
+         ga_info->scale_factor += 1.0 - (fit[i] + ga_info->scale_factor);
 
          /*--- The scale_factor has been changed ---*/
          sf_changed = TRUE;
       } 
 
       /*--- Make sure scale factor is still needed ---*/
-      if(pool->chrom[i]->fitness <= 0) all_positive = FALSE;
+      if(fit[i] <= 0) all_positive = FALSE;
    }
 
    /*--- Scale factor no longer needed ---*/
@@ -742,7 +1463,7 @@ PL_update_ptf(ga_info, pool)
    /*--- Find total fitness ---*/
    pool->total_fitness = 0;
    for(i = 0; i < pool->size; i++) {
-      pool->total_fitness += pool->chrom[i]->fitness + ga_info->scale_factor;
+      pool->total_fitness += fit[i] + ga_info->scale_factor;
    }
 
    /*--- Update ptf for each chromosome (minimize) ---*/
@@ -754,45 +1475,47 @@ PL_update_ptf(ga_info, pool)
       for(i = 0; i < pool->size; i++) {
 
          /*--- Failed scaling leads to divide by zero ---*/
-         if((pool->chrom[i]->fitness + ga_info->scale_factor) <= 0.0)
+         if((fit[i] + ga_info->scale_factor) <= 0.0)
             UT_error("PL_update_ptf: fitness + scale <= 0.0");
 
          /*--- Save new fitness in ptf ---*/
-         pool->chrom[i]->ptf = 
-            pool->total_fitness / 
-            (pool->chrom[i]->fitness + ga_info->scale_factor);
+         ptf[i] = pool->total_fitness / (fit[i] + ga_info->scale_factor);
 
          /*--- New total fitness based on new ptf ---*/
-         new_total_fitness += pool->chrom[i]->ptf;
+         new_total_fitness += ptf[i];
       }
 
-      /*--- Compute new ptf ---*/
-      for(i = 0; i < pool->size; i++) {
-
-         /*--- Failed scaling leads to divide by zero ---*/
-         if(new_total_fitness <= 0.0) 
-            UT_error("PL_update_ptf: new_total_fitness <= 0.0");
+      /*--- Failed scaling leads to divide by zero ---*/
+      if(pool->size > 0 && new_total_fitness <= 0.0) 
+         UT_error("PL_update_ptf: new_total_fitness <= 0.0");
 
-         /*--- New ptf ---*/
-         pool->chrom[i]->ptf *= 100.0 / new_total_fitness; 
-      }
+      /*--- Compute new ptf ---*/
+      for(i = 0; i < pool->size; i++)
+         ptf[i] *= 100.0 / new_total_fitness; 
 
    /*--- Update ptf for each chromosome (maximize) ---*/
    } else {
 
+      /*--- Failed scaling leads to divide by zero ---*/
+      if(pool->size > 0 && pool->total_fitness <= 0.0)
+         UT_error("PL_update_ptf: pool->total_fitness <= 0.0");
+
       /*--- Compute new ptf ---*/
-      for(i = 0; i < pool->size; i++) {
+      for(i = 0; i < pool->size; i++)
+         ptf[i] = ((fit[i] + ga_info->scale_factor) / 
+                   pool->total_fitness) * 100.0;
+   }
 
-         /*--- Failed scaling leads to divide by zero ---*/
-         if(pool->total_fitness <= 0.0)
-            UT_error("PL_update_ptf: pool->total_fitness <= 0.0");
+   /*--- Each chromosome keeps its own too ---*/
+   for(i = 0; i < pool->size; i++)
+      pool->chrom[i]->ptf = ptf[i];
 
-         /*--- New ptf ---*/
-         pool->chrom[i]->ptf = 
-            ((pool->chrom[i]->fitness + ga_info->scale_factor) / 
-            pool->total_fitness) * 100.0;
-      }
-   }
+   /*--- The roulette wheel (slices in double, not the float ptf) ---*/
+   if(pool->size <= 0) return OK;
+   wheel = pool->wheel;
+   for(i = 0; i < pool->size; i++)
+      wheel[i].cut = PL_SLICE(ga_info, pool, i);
+   PL_wheel(wheel, pool->size);
 
    return OK;
 }
@@ -853,20 +1576,23 @@ PL_insert(pool, index, chrom, make_copy)
    if(index < 0 || index > pool->max_size) 
       UT_error("PL_insert: invalid index");
 
-   /*--- Realloc for more space ---*/
+   /*--- Realloc for more space (doubling, so appends are amortized) ---*/
    if(index == pool->max_size) 
-      PL_resize(pool, pool->max_size + PL_ALLOC_SIZE);
+      PL_resize(pool, pool->max_size + MAX(PL_ALLOC_SIZE, pool->max_size));
  
-   /*--- Insert the chromosome ---*/
+   /*--- Insert the chromosome (already there: nothing to copy) ---*/
    if(make_copy) {
-      if(!CH_valid(pool->chrom[index])) 
-         pool->chrom[index] = CH_alloc(chrom->length);
-      CH_copy(chrom, pool->chrom[index]);
+      if(pool->chrom[index] != chrom) {
+         if(!CH_valid(pool->chrom[index])) 
+            pool->chrom[index] = PL_new_chrom(pool, chrom->length);
+         CH_copy(chrom, pool->chrom[index]);
+      }
    } else {
       if(CH_valid(pool->chrom[index])) 
          PL_remove(pool, index);
       pool->chrom[index] = chrom;
    }
+   PL_changed(pool, index);
 }
  
 /*----------------------------------------------------------------------------
@@ -881,8 +1607,9 @@ PL_remove(pool, index)
    if(index < 0 || index >= pool->max_size) 
       UT_error("PL_remove: invalid index");
 
-   if(CH_valid(pool->chrom[index])) CH_free(pool->chrom[index]);
+   if(CH_valid(pool->chrom[index])) PL_recycle(pool, pool->chrom[index]);
    pool->chrom[index] = NULL;
+   PL_changed(pool, index);
 }
 
 /*----------------------------------------------------------------------------
@@ -902,6 +1629,8 @@ PL_move(pool, idx_src, idx_dst)
    if(CH_valid(pool->chrom[idx_dst])) PL_remove(pool, idx_dst);
    pool->chrom[idx_dst] = pool->chrom[idx_src];
    pool->chrom[idx_src] = NULL;
+   PL_changed(pool, idx_src);
+   PL_changed(pool, idx_dst);
 }
 
 /*----------------------------------------------------------------------------
@@ -923,56 +1652,151 @@ PL_swap(pool, idx1, idx2)
    tmp               = pool->chrom[idx1];
    pool->chrom[idx1] = pool->chrom[idx2];
    pool->chrom[idx2] = tmp;
+   PL_changed(pool, idx1);
+   PL_changed(pool, idx2);
 }
 
 /*----------------------------------------------------------------------------
-| Sort comparison function for minimizing GA (ascending fitness)
+| Slot index of pool takes over chrom, a chromosome of pool from, which is
+| left with whatever the slot held before
+|
+| Instead of copying, the two chromosomes trade contents when their genes
+| can change hands: both on the heap, or both rows of the genes shared by
+| the two pools (see PL_arena_pair()).  Otherwise chrom is copied.
+|
+| NOTE: chromosomes themselves never change pools, so each pool can still
+|       be freed on its own.
+----------------------------------------------------------------------------*/
+PL_take(pool, index, from, chrom)
+   Pool_Ptr  pool, from;
+   int       index;
+   Chrom_Ptr chrom;
+{
+   Chrom_Ptr  dst;
+   Chrom_Type tmp;
+   int        arena, slot;
+
+   /*--- Error check ---*/
+   if(!PL_valid(pool)) UT_error("PL_take: invalid pool");
+   if(!PL_valid(from)) UT_error("PL_take: invalid from");
+   if(!CH_valid(chrom)) UT_error("PL_take: invalid chrom");
+   if(index < 0 || index >= pool->max_size) 
+      UT_error("PL_take: invalid index");
+
+   /*--- Make sure the slot has a chromosome ---*/
+   if(!CH_valid(pool->chrom[index]))
+      pool->chrom[index] = PL_new_chrom(pool, chrom->length);
+   dst = pool->chrom[index];
+   if(dst == chrom) {
+      PL_changed(pool, index);
+      return OK;
+   }
+   slot = chrom->index;
+
+   /*--- Genes can change hands: trade everything but the arena ---*/
+   if((dst->arena <= 0 && chrom->arena <= 0) ||
+      (dst->arena > 0 && dst->arena == chrom->arena &&
+       pool->arena_refs != NULL && pool->arena_refs == from->arena_refs)) {
+      tmp    = *dst;
+      *dst   = *chrom;
+      *chrom = tmp;
+      arena        = dst->arena;
+      dst->arena   = chrom->arena;
+      chrom->arena = arena;
+
+   /*--- Otherwise copy ---*/
+   } else {
+      CH_copy(chrom, dst);
+   }
+
+   /*--- Both slots have changed (chrom: if it is where it says) ---*/
+   PL_changed(pool, index);
+   chrom->index = slot;
+   if(slot >= 0 && slot < from->max_size && from->chrom[slot] == chrom)
+      PL_changed(from, slot);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Sort comparison function for minimizing GA (ascending fitness, then slot)
 ----------------------------------------------------------------------------*/
 static PL_cmp_min(a, b) 
-   Chrom_Ptr *a, *b;
+   Sort_Key_Ptr a, b;
 {
-   if((*a)->fitness < (*b)->fitness)
+   if(a->fitness < b->fitness)
       return -1;
-   else if((*a)->fitness > (*b)->fitness)
+   else if(a->fitness > b->fitness)
       return 1;
    else
-      return 0;
+      return a->index - b->index;
 }
 
 /*----------------------------------------------------------------------------
-| Sort comparison function for maximizing GA (descending fitness)
+| Sort comparison function for maximizing GA (descending fitness, then slot)
 ----------------------------------------------------------------------------*/
 static PL_cmp_max(a, b) 
-   Chrom_Ptr *a, *b;
+   Sort_Key_Ptr a, b;
 {
-   if((*a)->fitness < (*b)->fitness)
+   if(a->fitness < b->fitness)
       return 1;
-   else if((*a)->fitness > (*b)->fitness)
+   else if(a->fitness > b->fitness)
       return -1;
    else
-      return 0;
+      return a->index - b->index;
 }
 
 /*----------------------------------------------------------------------------
 | Sort the pool
+|
+| The (fitness, slot) keys of the chromosomes are sorted, rather than the
+| chromosomes through their pointers, and then the pointers are put in
+| that order.  Equal fitness keeps slot order, so the result is the same
+| whatever qsort() does with ties.
 ----------------------------------------------------------------------------*/
 PL_sort(ga_info, pool) 
    GA_Info_Ptr ga_info;
    Pool_Ptr    pool;
 {
+   Sort_Key_Ptr key;
+   Chrom_Ptr    tmp;
+   int          i, j, k;
+
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("PL_sort: invalid ga_info");
    if(!PL_valid(pool)) UT_error("PL_sort: invalid pool");
 
+   /*--- Keys ---*/
+   PL_room(pool);
+   key = pool->key;
+   for(i = 0; i < pool->size; i++) {
+      key[i].fitness = pool->fit[i];
+      key[i].index   = i;
+   }
+
    /*--- Sort based on objective ---*/
    if(ga_info->minimize)
-      qsort(pool->chrom, pool->size, sizeof(Chrom_Ptr), PL_cmp_min);
+      qsort(key, pool->size, sizeof(Sort_Key_Type), PL_cmp_min);
    else
-      qsort(pool->chrom, pool->size, sizeof(Chrom_Ptr), PL_cmp_max);
+      qsort(key, pool->size, sizeof(Sort_Key_Type), PL_cmp_max);
+
+   /*--- Slot i gets chrom[key[i].index], a cycle at a time ---*/
+   for(i = 0; i < pool->size; i++) {
+      if(key[i].index == i) continue;
+      tmp = pool->chrom[i];
+      for(j = i; (k = key[j].index) != i; j = k) {
+         pool->chrom[j] = pool->chrom[k];
+         key[j].index   = j;
+      }
+      pool->chrom[j] = tmp;
+      key[j].index   = j;
+   }
+   for(i = 0; i < pool->size; i++) pool->fit[i] = key[i].fitness;
 
    /*--- Reindex ---*/
    PL_index(pool);
 
-   /*--- Pool is now sorted ---*/
-   pool->sorted = TRUE;
+   /*--- Pool is now sorted (every slot may have changed) ---*/
+   pool->sorted    = TRUE;
+   pool->stat_size = -1;
 }
@@ -0,0 +1,412 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Evaluation processes
+|
+| Functions:
+|    PR_alloc()   - start evaluation processes
+|    PR_free()    - stop evaluation processes
+|    PR_valid()   - is a process pool valid?
+|    PR_eval()    - evaluate chromosomes on all processes
+|    PR_eval_on() - evaluate chromosomes on one process
+|    PR_serve()   - evaluation loop of a worker process (or external program)
+|
+| Utility
+|    PR_send()    - send chromosomes to a process
+|    PR_recv()    - receive their fitness
+|    PR_read()    - read exactly n bytes
+|    PR_write()   - write exactly n bytes
+|
+| NOTE: Each process has a copy of the caller's memory (made when PR_alloc()
+|       is called), so evaluation functions that use global variables work
+|       as usual, as long as the globals are set up before.  Changes made
+|       by the evaluation function (other than the fitness) are lost.
+|
+| Protocol (binary, in the byte order of the machine, over a pair of pipes):
+|
+|    request:  int num, int len, then num * len genes (Gene_Type)
+|    reply:    num fitness values (double)
+|
+|    A request with num == 0, or end of file, means quit.  An external
+|    evaluator (eval_cmd) reads requests from stdin and writes replies to
+|    stdout; written in C it is just PR_serve(obj_fun, 0, 1).
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*----------------------------------------------------------------------------
+| Start num evaluation processes
+|
+| If cmd is empty each process runs PR_serve() with EV_fun, otherwise each
+| one runs cmd (with /bin/sh), which must speak the protocol above.
+----------------------------------------------------------------------------*/
+PR_Pool_Ptr PR_alloc(num, cmd, EV_fun)
+   int  num;
+   char *cmd;
+   int  (*EV_fun)();
+{
+   PR_Pool_Ptr pr;
+   int         p, q, down[2], up[2];
+
+   /*--- Error check ---*/
+   if(num <= 0) UT_error("PR_alloc: invalid number of processes");
+   if((cmd == NULL || cmd[0] == '\0') && EV_fun == NULL)
+      UT_error("PR_alloc: null EV_fun");
+
+   /*--- Allocate memory ---*/
+   pr = (PR_Pool_Ptr)calloc(1, sizeof(PR_Pool_Type));
+   if(pr == NULL) UT_error("PR_alloc: alloc failed");
+   pr->pid     = (pid_t *)calloc(num, sizeof(pid_t));
+   pr->to      = (int *)calloc(num, sizeof(int));
+   pr->from    = (int *)calloc(num, sizeof(int));
+   pr->buf     = (Gene_Ptr *)calloc(num, sizeof(Gene_Ptr));
+   pr->buf_len = (int *)calloc(num, sizeof(int));
+   if(pr->pid == NULL || pr->to == NULL || pr->from == NULL ||
+      pr->buf == NULL || pr->buf_len == NULL)
+      UT_error("PR_alloc: alloc failed");
+
+   /*--- A dead process should be an error, not a signal ---*/
+   signal(SIGPIPE, SIG_IGN);
+
+   /*--- Nothing buffered may be written twice ---*/
+   fflush(NULL);
+
+   /*--- Start processes ---*/
+   for(p = 0; p < num; p++) {
+      if(pipe(down) < 0 || pipe(up) < 0) UT_error("PR_alloc: pipe failed");
+      if((pr->pid[p] = fork()) < 0) UT_error("PR_alloc: fork failed");
+
+      /*--- Child ---*/
+      if(pr->pid[p] == 0) {
+         for(q = 0; q < p; q++) {
+            close(pr->to[q]);
+            close(pr->from[q]);
+         }
+         close(down[1]);
+         close(up[0]);
+         if(cmd != NULL && cmd[0] != '\0') {
+            dup2(down[0], 0);
+            dup2(up[1], 1);
+            if(down[0] != 0) close(down[0]);
+            if(up[1] != 1)   close(up[1]);
+            execl("/bin/sh", "sh", "-c", cmd, (char *)NULL);
+            _exit(127);
+         }
+         PR_serve(EV_fun, down[0], up[1]);
+         _exit(0);
+      }
+
+      /*--- Parent ---*/
+      close(down[0]);
+      close(up[1]);
+      pr->to[p]   = down[1];
+      pr->from[p] = up[0];
+   }
+   pr->num_procs    = num;
+   pr->magic_cookie = PR_cookie;
+
+   return pr;
+}
+
+/*----------------------------------------------------------------------------
+| Stop evaluation processes (closing the pipes tells them to quit)
+----------------------------------------------------------------------------*/
+PR_free(pr)
+   PR_Pool_Ptr pr;
+{
+   int p;
+
+   /*--- Nothing to free ---*/
+   if(pr == NULL) return OK;
+
+   /*--- Error check ---*/
+   if(!PR_valid(pr)) UT_error("PR_free: invalid pr");
+
+   /*--- Stop processes ---*/
+   for(p = 0; p < pr->num_procs; p++) {
+      close(pr->to[p]);
+      close(pr->from[p]);
+   }
+   for(p = 0; p < pr->num_procs; p++)
+      while(waitpid(pr->pid[p], NULL, 0) < 0 && errno == EINTR)
+         ;
+
+   /*--- Free memory ---*/
+   for(p = 0; p < pr->num_procs; p++)
+      if(pr->buf[p] != NULL) free(pr->buf[p]);
+   free(pr->buf);
+   free(pr->buf_len);
+   free(pr->pid);
+   free(pr->to);
+   free(pr->from);
+   pr->magic_cookie = NL_cookie;
+   free(pr);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Is a process pool valid?
+----------------------------------------------------------------------------*/
+PR_valid(pr)
+   PR_Pool_Ptr pr;
+{
+   /*--- Check for NULL pointers ---*/
+   if(pr == NULL) return FALSE;
+
+   /*--- Check for magic cookie ---*/
+   if(pr->magic_cookie != PR_cookie) return FALSE;
+
+   /*--- Otherwise valid ---*/
+   return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+| Evaluate chrom[0..num-1] on all processes
+|
+| Chromosomes are sent in chunks; a process gets the next chunk as soon as
+| it is done with the last one, so cheap and expensive chromosomes even out.
+----------------------------------------------------------------------------*/
+PR_eval(pr, chrom, num)
+   PR_Pool_Ptr pr;
+   Chrom_Ptr   *chrom;
+   int         num;
+{
+   struct pollfd *pfd;
+   int           *first, *count;
+   int           p, chunk, next, busy;
+
+   /*--- Error check ---*/
+   if(!PR_valid(pr)) UT_error("PR_eval: invalid pr");
+   if(num <= 0) return OK;
+   if(chrom == NULL) UT_error("PR_eval: null chrom");
+
+   /*--- Allocate memory ---*/
+   pfd   = (struct pollfd *)calloc(pr->num_procs, sizeof(struct pollfd));
+   first = (int *)calloc(2 * pr->num_procs, sizeof(int));
+   if(pfd == NULL || first == NULL) UT_error("PR_eval: alloc failed");
+   count = first + pr->num_procs;
+
+   /*--- Give every process a chunk ---*/
+   chunk = MAX(1, num / (4 * pr->num_procs));
+   for(p = 0, next = 0, busy = 0; p < pr->num_procs; p++) {
+      pfd[p].fd     = -1;
+      pfd[p].events = POLLIN;
+      if(next >= num) continue;
+      first[p] = next;
+      count[p] = MIN(chunk, num - next);
+      next    += count[p];
+      PR_send(pr, p, chrom + first[p], count[p]);
+      pfd[p].fd = pr->from[p];
+      busy++;
+   }
+
+   /*--- Collect results, handing out the rest ---*/
+   while(busy > 0) {
+      if(poll(pfd, pr->num_procs, -1) < 0) {
+         if(errno == EINTR) continue;
+         UT_error("PR_eval: poll failed");
+      }
+      for(p = 0; p < pr->num_procs; p++) {
+         if(pfd[p].fd < 0 || pfd[p].revents == 0) continue;
+         PR_recv(pr, p, chrom + first[p], count[p]);
+         pfd[p].fd = -1;
+         busy--;
+         if(next >= num) continue;
+         first[p] = next;
+         count[p] = MIN(chunk, num - next);
+         next    += count[p];
+         PR_send(pr, p, chrom + first[p], count[p]);
+         pfd[p].fd = pr->from[p];
+         busy++;
+      }
+   }
+
+   free(pfd);
+   free(first);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Evaluate chrom[0..num-1] on process p only
+|
+| Different threads may use different processes at the same time.
+----------------------------------------------------------------------------*/
+PR_eval_on(pr, p, chrom, num)
+   PR_Pool_Ptr pr;
+   int         p;
+   Chrom_Ptr   *chrom;
+   int         num;
+{
+   /*--- Error check ---*/
+   if(!PR_valid(pr)) UT_error("PR_eval_on: invalid pr");
+   if(p < 0 || p >= pr->num_procs) UT_error("PR_eval_on: invalid process");
+   if(num <= 0) return OK;
+   if(chrom == NULL) UT_error("PR_eval_on: null chrom");
+
+   PR_send(pr, p, chrom, num);
+   PR_recv(pr, p, chrom, num);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Answer requests read from fd in with EV_fun, writing replies to fd out,
+| until told to quit
+----------------------------------------------------------------------------*/
+PR_serve(EV_fun, in, out)
+   int (*EV_fun)();
+   int in, out;
+{
+   Chrom_Ptr chrom = NULL;
+   double    *fit = NULL;
+   int       hdr[2], max_fit = 0, i;
+
+   /*--- Error check ---*/
+   if(EV_fun == NULL) UT_error("PR_serve: null EV_fun");
+
+   /*--- Each request ---*/
+   while(PR_read(in, (char *)hdr, sizeof(hdr)) == OK && hdr[0] > 0) {
+      if(hdr[1] <= 0) UT_error("PR_serve: invalid chromosome length");
+
+      /*--- Room for the chromosome and the reply ---*/
+      if(chrom == NULL || chrom->length != hdr[1]) {
+         if(chrom != NULL) CH_free(chrom);
+         chrom = CH_alloc(hdr[1]);
+      }
+      if(hdr[0] > max_fit) {
+         if(fit != NULL) free(fit);
+         max_fit = hdr[0];
+         if((fit = (double *)calloc(max_fit, sizeof(double))) == NULL)
+            UT_error("PR_serve: alloc failed");
+      }
+
+      /*--- Evaluate each chromosome ---*/
+      for(i = 0; i < hdr[0]; i++) {
+         if(PR_read(in, (char *)chrom->gene, hdr[1] * sizeof(Gene_Type))
+            != OK) UT_error("PR_serve: short request");
+         EV_fun(chrom);
+         fit[i] = chrom->fitness;
+      }
+
+      /*--- Reply ---*/
+      if(PR_write(out, (char *)fit, hdr[0] * sizeof(double)) != OK) break;
+   }
+
+   if(chrom != NULL) CH_free(chrom);
+   if(fit != NULL) free(fit);
+
+   return OK;
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Send chrom[0..num-1] to process p (all of the same length)
+----------------------------------------------------------------------------*/
+PR_send(pr, p, chrom, num)
+   PR_Pool_Ptr pr;
+   int         p;
+   Chrom_Ptr   *chrom;
+   int         num;
+{
+   int      hdr[2], i, len;
+   Gene_Ptr buf;
+
+   /*--- Room for all genes ---*/
+   len = chrom[0]->length;
+   if(num * len > pr->buf_len[p]) {
+      if(pr->buf[p] != NULL) free(pr->buf[p]);
+      pr->buf_len[p] = num * len;
+      pr->buf[p] = (Gene_Ptr)calloc(pr->buf_len[p], sizeof(Gene_Type));
+      if(pr->buf[p] == NULL) UT_error("PR_send: alloc failed");
+   }
+   buf = pr->buf[p];
+
+   /*--- Copy genes ---*/
+   for(i = 0; i < num; i++) {
+      if(chrom[i]->length != len) UT_error("PR_send: lengths differ");
+      memcpy(buf + i * len, chrom[i]->gene, len * sizeof(Gene_Type));
+   }
+
+   /*--- Send request ---*/
+   hdr[0] = num;
+   hdr[1] = len;
+   if(PR_write(pr->to[p], (char *)hdr, sizeof(hdr)) != OK ||
+      PR_write(pr->to[p], (char *)buf, num * len * sizeof(Gene_Type)) != OK)
+      UT_error("PR_send: evaluation process died");
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Receive fitness of chrom[0..num-1] from process p
+----------------------------------------------------------------------------*/
+PR_recv(pr, p, chrom, num)
+   PR_Pool_Ptr pr;
+   int         p;
+   Chrom_Ptr   *chrom;
+   int         num;
+{
+   double *fit;
+   int    i;
+
+   /*--- The genes have been sent, reuse their buffer (Gene_Type is double) ---*/
+   fit = (double *)pr->buf[p];
+
+   if(PR_read(pr->from[p], (char *)fit, num * sizeof(double)) != OK)
+      UT_error("PR_recv: evaluation process died");
+   for(i = 0; i < num; i++)
+      chrom[i]->fitness = fit[i];
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Read exactly n bytes from fd (ERROR on end of file)
+----------------------------------------------------------------------------*/
+PR_read(fd, buf, n)
+   int  fd;
+   char *buf;
+   int  n;
+{
+   int got;
+
+   while(n > 0) {
+      got = read(fd, buf, n);
+      if(got < 0 && errno == EINTR) continue;
+      if(got <= 0) return ERROR;
+      buf += got;
+      n   -= got;
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Write exactly n bytes to fd
+----------------------------------------------------------------------------*/
+PR_write(fd, buf, n)
+   int  fd;
+   char *buf;
+   int  n;
+{
+   int put;
+
+   while(n > 0) {
+      put = write(fd, buf, n);
+      if(put < 0 && errno == EINTR) continue;
+      if(put <= 0) return ERROR;
+      buf += put;
+      n   -= put;
+   }
+
+   return OK;
+}
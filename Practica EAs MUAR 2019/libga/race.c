@@ -0,0 +1,500 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Racing: compare configurations of a GA, dropping bad ones early
+|
+| Functions:
+|    RA_race()     - race some configurations (variants) against each other
+|    RA_item()     - helper for RA_race() (one run)
+|    RA_test()     - drop the variants that are significantly worse
+|    RA_report()   - print results of RA_race() as a ranked table
+|
+| Utility
+|    RA_ranks()    - rank sums of the variants left
+|    RA_cmp()      - compare two variants for RA_report()
+|    RA_chi2_q()   - upper tail of the chi square distribution
+|    RA_t_q()      - upper tail of Student's t distribution
+|    RA_t_inv()    - quantile of Student's t distribution
+|    RA_gamma_p()  - regularized incomplete gamma function
+|    RA_beta_i()   - regularized incomplete beta function
+|
+| NOTE: This is F-race (Birattari et al., 2002).  Block b is one run of each
+|       variant still in the race, all with seed rand_seed + b (and the same
+|       instance, see block_fun).  After min_blocks blocks, and after each
+|       block from then on, the variants left are ranked within every block
+|       and the Friedman test is done.  If they differ (p < alpha), every
+|       variant whose rank sum is significantly worse than the best one
+|       (Conover's post hoc test) is dropped.  With only two left, a paired
+|       t-test on the best fitness is used instead.  The race ends after
+|       max_blocks blocks or when a single variant is left.
+|
+|       The runs of a block are done in parallel, each with a ga_info of its
+|       own (see CF_clone()), so the evaluation function MUST be thread safe.
+|       Without block_fun several blocks may be run at once, to keep all
+|       threads busy; runs of a variant after the block in which it was
+|       dropped are not used, so results do not depend on the number of
+|       threads (only the number of runs done does).
+============================================================================*/
+#include "ga.h"
+#include <unistd.h>
+
+/*--- What each run needs ---*/
+typedef struct {
+   GA_Info_Ptr *var;        /* Variants */
+   int         num;         /* Number of variants */
+   double      *fit;        /* Best fitness, fit[b * num + v] */
+   int         *run_var;    /* Variant of each run */
+   int         *run_block;  /* Block of each run */
+} RA_Job_Type, *RA_Job_Ptr;
+
+void   RA_item();
+double RA_ranks(), RA_chi2_q(), RA_t_q(), RA_t_inv(), RA_gamma_p();
+double RA_beta_i();
+
+/*============================================================================
+|                                   Racing
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Race the num variants var[0..num-1] for at most max_blocks blocks, using
+| num_threads threads (all processors if num_threads <= 0)
+|
+| If block_fun is not NULL, block_fun(arg, b) is called before block b is
+| run (e.g. to switch instances).  The variants are not changed; res[v]
+| receives the results of var[v].  Returns the number of runs done.
+----------------------------------------------------------------------------*/
+RA_race(var, num, max_blocks, min_blocks, alpha, num_threads, block_fun, arg,
+        res)
+   GA_Info_Ptr   *var;
+   int           num, max_blocks, min_blocks;
+   double        alpha;
+   int           num_threads;
+   int           (*block_fun)();
+   void          *arg;
+   RA_Result_Ptr res;
+{
+   RA_Job_Type job;
+   TH_Pool_Ptr tp;
+   double      *rank;
+   int         v, b, nb, left, done, used, runs, num_jobs;
+
+   /*--- Error check ---*/
+   if(num <= 0 || max_blocks <= 0) return 0;
+   if(var == NULL || res == NULL) UT_error("RA_race: null var or res");
+   for(v = 0; v < num; v++)
+      if(!CF_valid(var[v])) UT_error("RA_race: invalid ga_info");
+   min_blocks = MAX(2, min_blocks);
+
+   /*--- How many threads? ---*/
+   if(num_threads <= 0) num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   num_threads = MAX(1, num_threads);
+
+   /*--- Work space ---*/
+   job.var       = var;
+   job.num       = num;
+   job.fit       = (double *)calloc(max_blocks * num, sizeof(double));
+   job.run_var   = (int *)calloc(max_blocks * num, sizeof(int));
+   job.run_block = (int *)calloc(max_blocks * num, sizeof(int));
+   rank          = (double *)calloc(num, sizeof(double));
+   if(job.fit == NULL || job.run_var == NULL || job.run_block == NULL ||
+      rank == NULL)
+      UT_error("RA_race: alloc failed");
+   for(v = 0; v < num; v++) {
+      res[v].runs = 0;
+      res[v].sum  = res[v].sum2 = res[v].rank = 0.0;
+      res[v].out  = 0;
+   }
+
+   tp = TH_alloc(MIN(num_threads, num * max_blocks));
+   left = num;
+   runs = used = 0;
+   for(done = 0; done < max_blocks && (left > 1 || num == 1); done += nb) {
+
+      /*--- How many blocks this time? ---*/
+      if(block_fun != NULL) {
+         nb = 1;
+         block_fun(arg, done);
+      } else {
+         nb = MAX(min_blocks - done, (num_threads + left - 1) / left);
+         nb = MIN(nb, max_blocks - done);
+      }
+
+      /*--- Run them ---*/
+      for(b = done, num_jobs = 0; b < done + nb; b++)
+         for(v = 0; v < num; v++) {
+            if(res[v].out) continue;
+            job.run_var[num_jobs]   = v;
+            job.run_block[num_jobs] = b;
+            num_jobs++;
+         }
+      TH_run(tp, RA_item, (void *)&job, num_jobs);
+      runs += num_jobs;
+
+      /*--- Results, one block after the other ---*/
+      for(b = done; b < done + nb; b++) {
+         if(left <= 1 && num > 1) break;
+         used++;
+         for(v = 0; v < num; v++) {
+            if(res[v].out) continue;
+            res[v].runs++;
+            res[v].sum  += job.fit[b * num + v];
+            res[v].sum2 += job.fit[b * num + v] * job.fit[b * num + v];
+         }
+         if(b + 1 >= min_blocks && left > 1)
+            left -= RA_test(var[0]->minimize, job.fit, num, b + 1, alpha, res);
+      }
+   }
+   TH_free(tp);
+
+   /*--- Mean ranks of the variants left ---*/
+   RA_ranks(var[0]->minimize, job.fit, num, used, res, rank);
+   for(v = 0; v < num; v++)
+      if(!res[v].out && used > 0) res[v].rank = rank[v] / used;
+
+   free(job.fit);
+   free(job.run_var);
+   free(job.run_block);
+   free(rank);
+
+   return runs;
+}
+
+/*----------------------------------------------------------------------------
+| Run i of RA_race()
+----------------------------------------------------------------------------*/
+void RA_item(arg, i, id)
+   void *arg;
+   int  i, id;
+{
+   RA_Job_Ptr  job;
+   GA_Info_Ptr ga_info;
+   int         v, b;
+
+   job = (RA_Job_Ptr)arg;
+   v   = job->run_var[i];
+   b   = job->run_block[i];
+
+   /*--- A quiet copy of the variant with the seed of the block ---*/
+   ga_info = CF_clone(job->var[v]);
+   ga_info->rand_seed    = job->var[v]->rand_seed + b;
+   ga_info->rp_type      = RP_NONE;
+   ga_info->eval_threads = 1;
+   ga_info->eval_procs   = 0;
+   ga_info->shm_name[0]  = '\0';
+
+   /*--- Run it ---*/
+   GA_run(ga_info);
+   job->fit[b * job->num + v] = ga_info->best->fitness;
+
+   CF_free(ga_info);
+}
+
+/*----------------------------------------------------------------------------
+| Test the variants left after num_blocks blocks; those significantly worse
+| than the best one are dropped.  Returns the number dropped.
+----------------------------------------------------------------------------*/
+RA_test(minimize, fit, num, num_blocks, alpha, res)
+   int           minimize;
+   double        *fit;
+   int           num, num_blocks;
+   double        alpha;
+   RA_Result_Ptr res;
+{
+   double *rank, a, c, sum, t, p, crit, d, sd;
+   int    v, w, b, best, k, n, num_out;
+
+   rank = (double *)calloc(num, sizeof(double));
+   if(rank == NULL) UT_error("RA_test: alloc failed");
+
+   /*--- Rank sums: sum of squared ranks is a, of squared rank sums sum ---*/
+   n = num_blocks;
+   a = RA_ranks(minimize, fit, num, n, res, rank);
+   for(v = 0, k = 0, sum = 0.0, best = -1; v < num; v++) {
+      if(res[v].out) continue;
+      k++;
+      sum += rank[v] * rank[v];
+      if(best < 0 || rank[v] < rank[best]) best = v;
+   }
+   c = n * k * (k + 1) * (k + 1) / 4.0;
+
+   num_out = 0;
+   if(k == 2) {
+
+      /*--- Paired t-test on the differences (positive: v is worse) ---*/
+      for(v = 0; res[v].out; v++)
+         ;
+      for(w = v + 1; res[w].out; w++)
+         ;
+      for(b = 0, d = sd = 0.0; b < n; b++) {
+         t = fit[b * num + v] - fit[b * num + w];
+         if(!minimize) t = -t;
+         d  += t;
+         sd += t * t;
+      }
+      sd = (sd - d * d / n) / (n - 1);
+      d /= n;
+      if(sd > 0.0) p = 2.0 * RA_t_q(fabs(d) / sqrt(sd / n), (double)(n - 1));
+      else         p = (d != 0.0) ? 0.0 : 1.0;
+      if(p < alpha) {
+         res[d > 0.0 ? v : w].out = num_blocks;
+         num_out = 1;
+      }
+   } else if(a - c > 0.0) {
+
+      /*--- Friedman test (a == c: all tied) ---*/
+      t = (k - 1) * (sum - n * c) / (a - c);
+      p = RA_chi2_q(t, (double)(k - 1));
+
+      /*--- Conover's post hoc test against the best ---*/
+      if(p < alpha) {
+         crit = RA_t_inv(1.0 - alpha / 2.0, (double)((n - 1) * (k - 1))) *
+                sqrt(2.0 * n * (a - sum / n) / ((n - 1) * (k - 1)));
+         for(v = 0; v < num; v++)
+            if(!res[v].out && rank[v] - rank[best] > crit) {
+               res[v].out = num_blocks;
+               num_out++;
+            }
+      }
+   }
+
+   /*--- Mean rank of those dropped ---*/
+   for(v = 0; v < num; v++)
+      if(res[v].out == num_blocks) res[v].rank = rank[v] / n;
+
+   free(rank);
+   return num_out;
+}
+
+/*----------------------------------------------------------------------------
+| Print results of RA_race() (num variants called name[v]) as a table, best
+| first; max_blocks and runs are used to compare with an exhaustive sweep
+----------------------------------------------------------------------------*/
+RA_report(fid, res, name, num, max_blocks, runs, minimize)
+   FILE          *fid;
+   RA_Result_Ptr res;
+   char          **name;
+   int           num, max_blocks, runs, minimize;
+{
+   int    *order, i, j, v;
+   double mean, dev;
+   char   status[20];
+
+   /*--- Error check ---*/
+   if(fid == NULL) UT_error("RA_report: invalid fid");
+   if(num <= 0) return OK;
+   if(res == NULL || name == NULL) UT_error("RA_report: null res or name");
+
+   /*--- Best first (insertion sort) ---*/
+   order = (int *)calloc(num, sizeof(int));
+   if(order == NULL) UT_error("RA_report: alloc failed");
+   for(i = 0; i < num; i++) {
+      for(j = i; j > 0 && RA_cmp(&res[i], &res[order[j-1]], minimize) < 0; j--)
+         order[j] = order[j-1];
+      order[j] = i;
+   }
+
+   /*--- Table ---*/
+   fprintf(fid, "Race: %d variants, %d runs of %d for an exhaustive sweep (%.1f%%)\n",
+           num, runs, num * max_blocks, 100.0 * runs / (num * max_blocks));
+   fprintf(fid, "%4s  %14s  %12s  %9s  %4s  %-10s  %s\n", "rank", "mean_best",
+           "std_dev", "mean_rank", "runs", "status", "variant");
+   for(i = 0; i < num; i++) {
+      v = order[i];
+      mean = dev = 0.0;
+      if(res[v].runs > 0) mean = res[v].sum / res[v].runs;
+      if(res[v].runs > 1)
+         dev = (res[v].sum2 - res[v].sum * mean) / (res[v].runs - 1);
+      if(res[v].out) sprintf(status, "out@%d", res[v].out);
+      else           sprintf(status, "left");
+      fprintf(fid, "%4d  %14.6g  %12.6g  %9.3f  %4d  %-10s  %s\n", i+1, mean,
+              dev > 0.0 ? sqrt(dev) : 0.0, res[v].rank, res[v].runs, status,
+              name[v]);
+   }
+   fflush(fid);
+
+   free(order);
+   return OK;
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Rank the variants left within each of the first num_blocks blocks (1 is
+| best, ties get their mean rank); rank[v] receives the rank sum of v.
+| Returns the sum of squared ranks.
+----------------------------------------------------------------------------*/
+double RA_ranks(minimize, fit, num, num_blocks, res, rank)
+   int           minimize;
+   double        *fit;
+   int           num, num_blocks;
+   RA_Result_Ptr res;
+   double        *rank;
+{
+   double *row, r, a;
+   int    v, w, b, better, same;
+
+   for(v = 0; v < num; v++) rank[v] = 0.0;
+   for(b = 0, a = 0.0; b < num_blocks; b++) {
+      row = fit + b * num;
+      for(v = 0; v < num; v++) {
+         if(res[v].out) continue;
+
+         /*--- Rank: 1 + number better + (number tied) / 2 ---*/
+         for(w = 0, better = same = 0; w < num; w++) {
+            if(w == v || res[w].out) continue;
+            if(row[w] == row[v])                       same++;
+            else if((row[w] < row[v]) == (minimize != 0)) better++;
+         }
+         r = 1.0 + better + same / 2.0;
+         rank[v] += r;
+         a += r * r;
+      }
+   }
+
+   return a;
+}
+
+/*----------------------------------------------------------------------------
+| Compare variants a and b for RA_report(): those left before those dropped,
+| those dropped later before those dropped earlier, then by mean rank and
+| mean fitness
+----------------------------------------------------------------------------*/
+RA_cmp(a, b, minimize)
+   RA_Result_Ptr a, b;
+   int           minimize;
+{
+   double ma, mb;
+
+   if(!a->out != !b->out) return a->out ? 1 : -1;
+   if(a->out != b->out)   return b->out - a->out;
+   if(a->rank != b->rank) return a->rank < b->rank ? -1 : 1;
+
+   ma = a->runs > 0 ? a->sum / a->runs : 0.0;
+   mb = b->runs > 0 ? b->sum / b->runs : 0.0;
+   if(ma == mb) return 0;
+   return ((ma < mb) == (minimize != 0)) ? -1 : 1;
+}
+
+/*----------------------------------------------------------------------------
+| P(X > x) for X chi square with df degrees of freedom
+----------------------------------------------------------------------------*/
+double RA_chi2_q(x, df)
+   double x, df;
+{
+   if(x <= 0.0) return 1.0;
+   return 1.0 - RA_gamma_p(df / 2.0, x / 2.0);
+}
+
+/*----------------------------------------------------------------------------
+| P(T > t) for T Student's t with df degrees of freedom (t >= 0)
+----------------------------------------------------------------------------*/
+double RA_t_q(t, df)
+   double t, df;
+{
+   return 0.5 * RA_beta_i(df / 2.0, 0.5, df / (df + t * t));
+}
+
+/*----------------------------------------------------------------------------
+| t such that P(T <= t) = p for T Student's t with df degrees of freedom
+| (0.5 <= p < 1), by bisection
+----------------------------------------------------------------------------*/
+double RA_t_inv(p, df)
+   double p, df;
+{
+   double lo, hi, mid;
+   int    i;
+
+   for(hi = 1.0; 1.0 - RA_t_q(hi, df) < p && hi < 1e6; hi *= 2.0)
+      ;
+   for(i = 0, lo = 0.0; i < 100; i++) {
+      mid = (lo + hi) / 2.0;
+      if(1.0 - RA_t_q(mid, df) < p) lo = mid;
+      else                          hi = mid;
+   }
+
+   return (lo + hi) / 2.0;
+}
+
+/*----------------------------------------------------------------------------
+| Regularized incomplete gamma function P(a, x) (series or continued
+| fraction, see Numerical Recipes 6.2)
+----------------------------------------------------------------------------*/
+double RA_gamma_p(a, x)
+   double a, x;
+{
+   double sum, del, ap, b, c, d, h, an;
+   int    i;
+
+   if(x <= 0.0) return 0.0;
+
+   /*--- Series ---*/
+   if(x < a + 1.0) {
+      ap  = a;
+      sum = del = 1.0 / a;
+      for(i = 0; i < 500 && fabs(del) > fabs(sum) * 1e-15; i++) {
+         ap  += 1.0;
+         del *= x / ap;
+         sum += del;
+      }
+      return sum * exp(-x + a * log(x) - lgamma(a));
+   }
+
+   /*--- Continued fraction (modified Lentz) ---*/
+   b = x + 1.0 - a;
+   c = 1.0 / 1e-300;
+   d = h = 1.0 / b;
+   for(i = 1; i < 500; i++) {
+      an = -i * (i - a);
+      b += 2.0;
+      d  = an * d + b;
+      if(fabs(d) < 1e-300) d = 1e-300;
+      c  = b + an / c;
+      if(fabs(c) < 1e-300) c = 1e-300;
+      d  = 1.0 / d;
+      del = d * c;
+      h *= del;
+      if(fabs(del - 1.0) < 1e-15) break;
+   }
+   return 1.0 - exp(-x + a * log(x) - lgamma(a)) * h;
+}
+
+/*----------------------------------------------------------------------------
+| Regularized incomplete beta function I_x(a, b) (continued fraction, see
+| Numerical Recipes 6.4)
+----------------------------------------------------------------------------*/
+double RA_beta_i(a, b, x)
+   double a, b, x;
+{
+   double front, c, d, f, num;
+   int    i, m;
+
+   if(x <= 0.0) return 0.0;
+   if(x >= 1.0) return 1.0;
+
+   /*--- Continued fraction converges fast only for x < (a+1)/(a+b+2) ---*/
+   if(x > (a + 1.0) / (a + b + 2.0))
+      return 1.0 - RA_beta_i(b, a, 1.0 - x);
+
+   front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) +
+               a * log(x) + b * log(1.0 - x)) / a;
+
+   /*--- Modified Lentz ---*/
+   f = c = 1.0;
+   d = 0.0;
+   for(i = 0; i <= 400; i++) {
+      m = i / 2;
+      if(i == 0)          num = 1.0;
+      else if(i % 2 == 0) num = (m * (b - m) * x) / ((a + 2.0*m - 1.0) * (a + 2.0*m));
+      else                num = -((a + m) * (a + b + m) * x) /
+                                 ((a + 2.0*m) * (a + 2.0*m + 1.0));
+      d = 1.0 + num * d;
+      if(fabs(d) < 1e-300) d = 1e-300;
+      d = 1.0 / d;
+      c = 1.0 + num / c;
+      if(fabs(c) < 1e-300) c = 1e-300;
+      f *= c * d;
+      if(fabs(1.0 - c * d) < 1e-15) break;
+   }
+
+   return front * (f - 1.0);
+}
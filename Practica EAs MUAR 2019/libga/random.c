@@ -0,0 +1,289 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Random number generator
+|
+| Functions:
+|    RN_seed()      - seed a generator
+|    RN_jump()      - jump ahead 2^128 numbers (independent stream)
+|    RN_next()      - next 64 random bits
+|    RN_frac()      - random double in [0..1)
+|    RN_dom()       - random int in [lo..hi], unbiased
+|    RN_bit()       - random bit
+|    RN_bits()      - up to 64 random bits, as RN_bit() would give them
+|    RN_fill_bits() - fill an array of genes with random bits
+|    RN_fill_words()- fill an array of packed bit genes with random bits
+|    RN_fill_frac() - fill an array of doubles from [0..1)
+|    RN_fill_fracf()- fill an array of floats from [0..1)
+|
+| NOTE: The generator is xoshiro256** by D. Blackman and S. Vigna.  Every
+|       ga_info has its own (ga_info->rn), so runs in different threads
+|       neither share nor disturb each other's random numbers.  Use
+|       RN_jump() to give each of several generators a separate stream.
+============================================================================*/
+#include "ga.h"
+
+#define RN_ROTL(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+/*----------------------------------------------------------------------------
+| Seed a generator (the state is filled in with splitmix64)
+----------------------------------------------------------------------------*/
+RN_seed(rn, seed)
+   RN_Ptr        rn;
+   unsigned long seed;
+{
+   RN_Word z, x;
+   int     i;
+
+   /*--- Error check ---*/
+   if(rn == NULL) UT_error("RN_seed: null rn");
+
+   /*--- splitmix64 never gives an all zero state ---*/
+   x = (RN_Word)seed;
+   for(i = 0; i < 4; i++) {
+      z = (x += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      rn->s[i] = z ^ (z >> 31);
+   }
+
+   /*--- No bits saved ---*/
+   rn->bits     = 0;
+   rn->num_bits = 0;
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Jump ahead 2^128 numbers; equivalent to that many calls to RN_next()
+----------------------------------------------------------------------------*/
+RN_jump(rn)
+   RN_Ptr rn;
+{
+   static RN_Word jump[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                             0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+   RN_Word s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+   int     i, b;
+
+   /*--- Error check ---*/
+   if(rn == NULL) UT_error("RN_jump: null rn");
+
+   for(i = 0; i < 4; i++)
+      for(b = 0; b < 64; b++) {
+         if(jump[i] & ((RN_Word)1 << b)) {
+            s0 ^= rn->s[0];
+            s1 ^= rn->s[1];
+            s2 ^= rn->s[2];
+            s3 ^= rn->s[3];
+         }
+         RN_next(rn);
+      }
+
+   rn->s[0] = s0;
+   rn->s[1] = s1;
+   rn->s[2] = s2;
+   rn->s[3] = s3;
+
+   /*--- Saved bits belong to the old stream ---*/
+   rn->bits     = 0;
+   rn->num_bits = 0;
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Next 64 random bits
+----------------------------------------------------------------------------*/
+RN_Word RN_next(rn)
+   RN_Ptr rn;
+{
+   RN_Word *s, result, t;
+
+   s      = rn->s;
+   result = RN_ROTL(s[1] * 5, 7) * 9;
+   t      = s[1] << 17;
+
+   s[2] ^= s[0];
+   s[3] ^= s[1];
+   s[1] ^= s[2];
+   s[0] ^= s[3];
+   s[2] ^= t;
+   s[3]  = RN_ROTL(s[3], 45);
+
+   return result;
+}
+
+/*----------------------------------------------------------------------------
+| Random double in [0..1) (53 bits)
+----------------------------------------------------------------------------*/
+double RN_frac(rn)
+   RN_Ptr rn;
+{
+   return (double)(RN_next(rn) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*----------------------------------------------------------------------------
+| Random int in [lo..hi] without modulo bias (Lemire's method)
+----------------------------------------------------------------------------*/
+RN_dom(rn, lo, hi)
+   RN_Ptr rn;
+   int    lo, hi;
+{
+   RN_Word      m;
+   unsigned int range, l, t;
+
+   /*--- Degenerate domain ---*/
+   if(hi <= lo) return lo;
+
+   /*--- range is 0 for the full 32 bit domain ---*/
+   range = (unsigned int)hi - (unsigned int)lo + 1;
+   if(range == 0) return (int)(RN_next(rn) >> 32);
+
+   /*--- Multiply up, and reject the few values that would bias ---*/
+   m = (RN_next(rn) >> 32) * (RN_Word)range;
+   l = (unsigned int)m;
+   if(l < range) {
+      t = (0U - range) % range;
+      while(l < t) {
+         m = (RN_next(rn) >> 32) * (RN_Word)range;
+         l = (unsigned int)m;
+      }
+   }
+
+   return lo + (int)(m >> 32);
+}
+
+/*----------------------------------------------------------------------------
+| Random bit (64 bits are drawn at a time)
+----------------------------------------------------------------------------*/
+RN_bit(rn)
+   RN_Ptr rn;
+{
+   int bit;
+
+   if(rn->num_bits == 0) {
+      rn->bits     = RN_next(rn);
+      rn->num_bits = 64;
+   }
+   bit = (int)(rn->bits & 1);
+   rn->bits >>= 1;
+   rn->num_bits--;
+
+   return bit;
+}
+
+/*----------------------------------------------------------------------------
+| num (1..64) random bits: bit i is what the i-th call to RN_bit() would give
+----------------------------------------------------------------------------*/
+RN_Word RN_bits(rn, num)
+   RN_Ptr rn;
+   int    num;
+{
+   RN_Word bits;
+   int     n;
+
+   /*--- Error check ---*/
+   if(num <= 0 || num > 64) UT_error("RN_bits: invalid num");
+
+   /*--- Unused bits first ---*/
+   n    = MIN(num, rn->num_bits);
+   bits = n ? rn->bits & (~(RN_Word)0 >> (64 - n)) : 0;
+   rn->bits      = n < 64 ? rn->bits >> n : 0;
+   rn->num_bits -= n;
+
+   /*--- Then a new number ---*/
+   if(n < num) {
+      rn->bits      = RN_next(rn);
+      rn->num_bits  = 64;
+      bits         |= (rn->bits & (~(RN_Word)0 >> (64 - (num - n)))) << n;
+      rn->bits      = num - n < 64 ? rn->bits >> (num - n) : 0;
+      rn->num_bits -= num - n;
+   }
+
+   return bits;
+}
+
+/*----------------------------------------------------------------------------
+| Set gene[0..num-1] to random bits
+----------------------------------------------------------------------------*/
+RN_fill_bits(rn, gene, num)
+   RN_Ptr   rn;
+   Gene_Ptr gene;
+   int      num;
+{
+   RN_Word bits;
+   int     i, j, n;
+
+   /*--- Error check ---*/
+   if(num > 0 && gene == NULL) UT_error("RN_fill_bits: null gene");
+
+   /*--- 64 genes per number ---*/
+   for(i = 0; i < num; i += 64) {
+      bits = RN_next(rn);
+      n    = MIN(64, num - i);
+      for(j = 0; j < n; j++, bits >>= 1)
+         gene[i + j] = (Gene_Type)(bits & 1);
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Set packed bit genes 0..num-1 to the bits RN_fill_bits() would give
+----------------------------------------------------------------------------*/
+RN_fill_words(rn, word, num)
+   RN_Ptr   rn;
+   CH_Word  *word;
+   int      num;
+{
+   int i;
+
+   /*--- Error check ---*/
+   if(num > 0 && word == NULL) UT_error("RN_fill_words: null word");
+
+   /*--- A number per word, unused bits of the last one cleared ---*/
+   for(i = 0; i < CH_WORDS(num); i++)
+      word[i] = RN_next(rn);
+   if(num % CH_WORD_BITS)
+      word[i-1] &= ~(CH_Word)0 >> (CH_WORD_BITS - num % CH_WORD_BITS);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Set x[0..num-1] to random doubles from [0..1)
+----------------------------------------------------------------------------*/
+RN_fill_frac(rn, x, num)
+   RN_Ptr rn;
+   double *x;
+   int    num;
+{
+   int i;
+
+   /*--- Error check ---*/
+   if(num > 0 && x == NULL) UT_error("RN_fill_frac: null x");
+
+   for(i = 0; i < num; i++)
+      x[i] = (double)(RN_next(rn) >> 11) * (1.0 / 9007199254740992.0);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Set x[0..num-1] to random floats from [0..1) (24 bits, exact in a float)
+----------------------------------------------------------------------------*/
+RN_fill_fracf(rn, x, num)
+   RN_Ptr rn;
+   float  *x;
+   int    num;
+{
+   int i;
+
+   /*--- Error check ---*/
+   if(num > 0 && x == NULL) UT_error("RN_fill_fracf: null x");
+
+   for(i = 0; i < num; i++)
+      x[i] = (float)(RN_next(rn) >> 40) * (1.0f / 16777216.0f);
+
+   return OK;
+}
@@ -47,7 +47,8 @@ RE_set_fun(ga_info, fn_name, fn_ptr)
    char         *fn_name;
    FN_Ptr       fn_ptr;
 {
-   return FN_set_fun(ga_info, RE_table, fn_name, fn_ptr, &ga_info->RE_fun);
+   return FN_set_fun(ga_info, &ga_info->RE_user, fn_name, fn_ptr, 
+                     &ga_info->RE_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -57,7 +58,8 @@ RE_select(ga_info, fn_name)
    GA_Info_Ptr  ga_info;
    char         *fn_name;
 {
-   return FN_select(ga_info, RE_table, fn_name, &ga_info->RE_fun);
+   return FN_select(ga_info, RE_table, &ga_info->RE_user, fn_name, 
+                    &ga_info->RE_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -66,7 +68,7 @@ RE_select(ga_info, fn_name)
 char *RE_name(ga_info)
    GA_Info_Ptr  ga_info;
 {
-   return FN_name(ga_info, RE_table, ga_info->RE_fun);
+   return FN_name(ga_info, RE_table, &ga_info->RE_user, ga_info->RE_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -10,8 +10,10 @@
 |    RP_time()   - time for a report?
 |    RP_short()  - short report format
 |    RP_long()   - long report format
+|    RP_islands() - periodic report for the island model
 ============================================================================*/
 #include "ga.h"
+#include <string.h>
 
 /*----------------------------------------------------------------------------
 | Print a report
@@ -88,13 +90,75 @@ void RP_final(ga_info)
    /*--- Print best ---*/
    fprintf(ga_info->rp_fid,"\nBest: ");
    for(i = 0; i < ga_info->best->length; i++) {
-      fprintf(ga_info->rp_fid,"%G ", ga_info->best->gene[i]);
+      fprintf(ga_info->rp_fid,"%G ", CH_gene(ga_info->best, i));
       if(i % 20 == 19 && i+1 < ga_info->best->length) 
          fprintf(ga_info->rp_fid,"\n      ");
    }
    fprintf(ga_info->rp_fid," (%g)\n\n", ga_info->best->fitness);
 }
 
+/*----------------------------------------------------------------------------
+| Print a report for the island model: statistics of all islands together,
+| and for long reports one line per island
+----------------------------------------------------------------------------*/
+void RP_islands(ga_info, isl, num)
+   GA_Info_Ptr    ga_info, *isl;
+   int            num;
+{
+   Pool_Type all;
+   Chrom_Ptr none = NULL;
+   Pool_Ptr  pool;
+   double    sum2;
+   int       i, size;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("RP_islands: invalid ga_info");
+   if(isl == NULL || num <= 0) UT_error("RP_islands: invalid islands");
+
+   /*--- Nothing to report? ---*/
+   if(ga_info->rp_type != RP_SHORT && ga_info->rp_type != RP_LONG) return;
+
+   /*--- Statistics of all pools together (island pools may only hold
+        statistics, e.g. in the coordinator: chrom is just for PL_valid()) ---*/
+   memset(&all, 0, sizeof(all));
+   all.magic_cookie  = PL_cookie;
+   all.chrom         = &none;
+   all.total_fitness = 0.0;
+   sum2              = 0.0;
+   size              = 0;
+   for(i = 0; i < num; i++) {
+      pool = isl[i]->old_pool;
+      if(i == 0 || pool->min < all.min) all.min = pool->min;
+      if(i == 0 || pool->max > all.max) all.max = pool->max;
+      all.total_fitness += pool->total_fitness;
+      sum2 += pool->var * (pool->size - 1) + pool->ave * pool->total_fitness;
+      size += pool->size;
+   }
+   all.size = size;
+   all.ave  = all.total_fitness / size;
+   all.var  = (size > 1) ? (sum2 - all.ave * all.total_fitness) / (size - 1)
+                         : 0.0;
+   if(all.var < 0.0) all.var = 0.0;
+   all.dev  = sqrt(all.var);
+
+   /*--- Is it report time? ---*/
+   if(!RP_time(ga_info, &all)) return;
+
+   /*--- Same format as a short report ---*/
+   RP_short(ga_info, &all);
+
+   /*--- Then each island ---*/
+   if(ga_info->rp_type != RP_LONG) return;
+   for(i = 0; i < num; i++) {
+      pool = isl[i]->old_pool;
+      fprintf(ga_info->rp_fid,
+         "  #%-3d %7.6G  %7.6G  %7.3G  %8.3G  %7.3G  %7.6G  %7.6G\n", 
+         i+1, pool->min, pool->max, pool->ave, pool->var, pool->dev,
+         pool->total_fitness, isl[i]->best->fitness);
+   }
+   fflush(ga_info->rp_fid);
+}
+
 /*----------------------------------------------------------------------------
 | See if time to print a report
 ----------------------------------------------------------------------------*/
@@ -159,7 +223,7 @@ RP_long(ga_info, pool)
    GA_Info_Ptr  ga_info;
    Pool_Ptr     pool;
 {
-   int i, j;
+   int i, j, num;
 
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("RP_long: invalid ga_info");
@@ -180,30 +244,37 @@ RP_long(ga_info, pool)
    fprintf(ga_info->rp_fid," # Parents  XP   Fitness  String\n");
    fprintf(ga_info->rp_fid,"-- ------- ----- -------  ------\n");
 
-   /*--- Print pool ---*/
-   for(i = 0; i < pool->size; i++) {
+   /*--- Print pool (the first rp_chroms only, if set) ---*/
+   num = pool->size;
+   if(ga_info->rp_chroms >= 0 && ga_info->rp_chroms < num)
+      num = ga_info->rp_chroms;
+   for(i = 0; i < num; i++) {
      fprintf(ga_info->rp_fid,"%2d (%2d,%2d) %2d %2d %7G  ",
         i+1, pool->chrom[i]->parent_1 + 1, pool->chrom[i]->parent_2 + 1, 
         pool->chrom[i]->xp1 + 1, pool->chrom[i]->xp2 + 1, 
         pool->chrom[i]->fitness);
      for(j = 0; j < pool->chrom[i]->length; j++) {
-        fprintf(ga_info->rp_fid,"%G ", pool->chrom[i]->gene[j]);
+        fprintf(ga_info->rp_fid,"%G ", CH_gene(pool->chrom[i], j));
         if(j % 15 == 14 && j+1 < pool->chrom[i]->length) 
            fprintf(ga_info->rp_fid,"\n                                  ");
      }
      fprintf(ga_info->rp_fid,"\n");
    }
+   if(num < pool->size)
+      fprintf(ga_info->rp_fid,"   ... (%d more)\n", pool->size - num);
 
    /*--- Statistics ---*/
    fprintf(ga_info->rp_fid,
       "\nMin= %G   Max= %G   Ave= %.2G   Tot= %G   Var= %.2G   SD= %.2G\n", 
       pool->min, pool->max, pool->ave, pool->total_fitness, 
       pool->var, pool->dev);
+   fprintf(ga_info->rp_fid,"Allocations= %ld (%d spare)\n", 
+      pool->num_alloc, pool->num_spare);
 
    /*--- Print best ---*/
    fprintf(ga_info->rp_fid,"\nBest: ");
    for(i = 0; i < ga_info->best->length; i++) {
-      fprintf(ga_info->rp_fid,"%G ", ga_info->best->gene[i]);
+      fprintf(ga_info->rp_fid,"%G ", CH_gene(ga_info->best, i));
       if(i % 20 == 19 && i+1 < ga_info->best->length) 
          fprintf(ga_info->rp_fid,"\n      ");
    }
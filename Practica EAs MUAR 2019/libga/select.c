@@ -6,9 +6,10 @@
 | Operators
 |    SE_uniform_random()  - just pick one
 |    SE_roulette()        - standard roulette
-|       SE_max_roulette() - helper for roulette (maximizing)
-|       SE_min_roulette() - helper for roulette (minimizing)
+|       SE_spin()         - helper for roulette (spin the wheel)
 |    SE_rank_biased()     - standard linear bias 
+|    SE_sus()             - stochastic universal sampling
+|       SE_sus_batch()    - helper for sus (a whole batch at once)
 |
 | Interface
 |    SE_table[]   - used in selection of selection method
@@ -16,10 +17,14 @@
 |    SE_select()  - select selection method by name
 |    SE_name()    - get name of current selection method
 |    SE_fun()     - setup and perform selection operator
+|    SE_prepare() - prepare pool so that SE_fun() only reads it
+|    SE_batch()   - select a batch of chromosomes at once
 ============================================================================*/
 #include "ga.h"
+#include <float.h>
 
-int SE_uniform_random(), SE_roulette(), SE_rank_biased();
+int SE_uniform_random(), SE_roulette(), SE_rank_biased(), SE_sus();
+static int SE_spin(), SE_sus_batch();
 
 /*============================================================================
 |                     Selection interface
@@ -32,6 +37,7 @@ FN_Table_Type SE_table[] = {
    { "uniform_random", SE_uniform_random },
    { "roulette",       SE_roulette       },
    { "rank_biased",    SE_rank_biased    },
+   { "sus",            SE_sus            },
    { NULL,             NULL              }
 };
 
@@ -43,7 +49,8 @@ SE_set_fun(ga_info, fn_name, fn_ptr)
    char         *fn_name;
    FN_Ptr       fn_ptr;
 {
-   return FN_set_fun(ga_info, SE_table, fn_name, fn_ptr, &ga_info->SE_fun);
+   return FN_set_fun(ga_info, &ga_info->SE_user, fn_name, fn_ptr, 
+                     &ga_info->SE_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -53,7 +60,8 @@ SE_select(ga_info, fn_name)
    GA_Info_Ptr  ga_info;
    char         *fn_name;
 {
-   return FN_select(ga_info, SE_table, fn_name, &ga_info->SE_fun);
+   return FN_select(ga_info, SE_table, &ga_info->SE_user, fn_name, 
+                    &ga_info->SE_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -62,7 +70,7 @@ SE_select(ga_info, fn_name)
 char *SE_name(ga_info)
    GA_Info_Ptr  ga_info;
 {
-   return FN_name(ga_info, SE_table, ga_info->SE_fun);
+   return FN_name(ga_info, SE_table, &ga_info->SE_user, ga_info->SE_fun);
 }
 
 /*----------------------------------------------------------------------------
@@ -87,6 +95,77 @@ Chrom_Ptr SE_fun(ga_info, pool)
    return pool->chrom[idx];
 }
 
+/*----------------------------------------------------------------------------
+| Prepare pool for selection, so that SE_fun() only reads it
+|
+| For copies of ga_info with se_ready set which select from the same pool
+| at the same time (see breed.c).
+----------------------------------------------------------------------------*/
+SE_prepare(ga_info, pool)
+   GA_Info_Ptr    ga_info;
+   Pool_Ptr       pool;
+{
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("SE_prepare: invalid ga_info");
+
+   /*--- Roulette and sus: PTF of each chromosome ---*/
+   if(ga_info->SE_fun == SE_roulette || ga_info->SE_fun == SE_sus)
+      PL_update_ptf(ga_info, pool);
+
+   /*--- Rank biased: rank pool (once if replacement is by_rank) ---*/
+   if(ga_info->SE_fun == SE_rank_biased && !ga_info->ranked) {
+      PL_sort(ga_info, pool);
+      if(!strcmp(RE_name(ga_info), "by_rank")) ga_info->ranked = TRUE;
+   }
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Select num chromosomes of pool into chrom[] at once
+|
+| Same as num calls of SE_fun(), but checked once for all of them and with
+| the pool prepared once (unless se_ready).  Sus samples the whole batch at
+| once (see SE_sus_batch()); other methods are called num times in a row.
+----------------------------------------------------------------------------*/
+SE_batch(ga_info, pool, chrom, num)
+   GA_Info_Ptr    ga_info;
+   Pool_Ptr       pool;
+   Chrom_Ptr      *chrom;
+   int            num;
+{
+   int i, idx, ready;
+
+   /*--- Error check ---*/
+   if(!CF_valid(ga_info)) UT_error("SE_batch: invalid ga_info");
+   if(ga_info->SE_fun == NULL) UT_error("SE_batch: null SE_fun");
+   if(!PL_valid(pool)) UT_error("SE_batch: invalid pool");
+   if(num > 0 && chrom == NULL) UT_error("SE_batch: null chrom");
+   if(num <= 0) return OK;
+   if(pool->size <= 0) UT_error("SE_batch: empty pool");
+   for(i = 0; i < pool->size; i++)
+      if(pool->chrom[i] == NULL) UT_error("SE_batch: null pool->chrom[i]");
+
+   /*--- Prepare the pool once ---*/
+   ready = ga_info->se_ready;
+   if(!ready) SE_prepare(ga_info, pool);
+   ga_info->se_ready = TRUE;
+
+   /*--- Select ---*/
+   if(ga_info->SE_fun == SE_sus) {
+      SE_sus_batch(ga_info, pool, chrom, num);
+   } else {
+      for(i = 0; i < num; i++) {
+         idx = ga_info->SE_fun(ga_info, pool);
+         if(idx < 0 || idx >= pool->size) UT_error("SE_batch: invalid idx");
+         chrom[i] = pool->chrom[idx];
+      }
+   }
+   ga_info->se_ready = ready;
+
+   return OK;
+}
+
 /*============================================================================
 |                             Selection Methods
 ============================================================================*/
@@ -100,7 +179,7 @@ SE_uniform_random(ga_info, pool)
    /*--- Error check ---*/
    if(!CF_valid(ga_info)) UT_error("SE_uniform_random: invalid ga_info");
 
-   return RAND_DOM(0, pool->size-1);
+   return RN_dom(&ga_info->rn, 0, pool->size-1);
 }
 
 /*----------------------------------------------------------------------------
@@ -114,83 +193,132 @@ SE_roulette(ga_info, pool)
    if(!CF_valid(ga_info)) UT_error("SE_roulette: invalid ga_info");
 
    /*--- Find PTF for each chromosome ---*/                         
-   PL_update_ptf(ga_info, pool);
+   if(!ga_info->se_ready) PL_update_ptf(ga_info, pool);
 
-   if(ga_info->minimize)         
-      return SE_min_roulette(ga_info, pool);
-   else
-      return SE_max_roulette(ga_info, pool);
+   return SE_spin(ga_info, pool);
 }      
 
 /*----------------------------------------------------------------------------
-| Roulette helper (maximizing)
+| Roulette helper: spin the wheel of the pool (see PL_update_ptf()), an
+| alias table, with a single random number
+|
+| Its whole part picks a slot and the rest says whether to keep it or take
+| its alias, so a spin is O(1) whatever the size of the pool.
 ----------------------------------------------------------------------------*/
-SE_max_roulette(ga_info, pool)
+static SE_spin(ga_info, pool)
    GA_Info_Ptr ga_info;
    Pool_Ptr    pool;
 {
-   int   i = 0;
-   float val = 0.0, spin_val;
+   double spin_val;
+   int    j;
+
+   /*--- Nothing to spin ---*/
+   if(pool->size <= 0) return 0;
 
+   /*--- Spin the wheel (value between 0.0 and pool->size) ---*/
+   spin_val = RN_frac(&ga_info->rn) * pool->size;
+
+   /*--- Slot, or its alias ---*/
+   j = (int)spin_val;
+   if(j >= pool->size) j = pool->size - 1;
+   if(spin_val - j < pool->wheel[j].cut) return j;
+   return pool->wheel[j].alias;
+}
+
+/*----------------------------------------------------------------------------
+| Rank biased 
+----------------------------------------------------------------------------*/
+SE_rank_biased(ga_info, pool)
+   GA_Info_Ptr ga_info;
+   Pool_Ptr    pool;
+{
    /*--- Error check ---*/
-   if(!CF_valid(ga_info)) UT_error("SE_max_roulette: invalid ga_info");
+   if(!CF_valid(ga_info)) UT_error("SE_rank_biased: invalid ga_info");
 
-   /*--- Spin the wheel ---*/
-   spin_val = RAND_FRAC() * pool->total_fitness;
+   /*--- Rank pool ---*/
+   if(!ga_info->ranked && !ga_info->se_ready) {
+      PL_sort(ga_info, pool);
 
-   /*--- Find corresponding chromosome ---*/
-   while(val < spin_val && i < pool->size)
-      val += pool->chrom[i++]->fitness;
-   if(i > 0) i--;
+      /*--- Only rank once if replacement is by_rank ---*/
+      if(!strcmp(RE_name(ga_info), "by_rank")) ga_info->ranked = TRUE;
+   }
 
-   return i;
+   /*--- Linear biased selection ---*/
+   return pool->size * (ga_info->bias - sqrt(ga_info->bias * ga_info->bias
+          - 4.0 * (ga_info->bias-1) * RN_frac(&ga_info->rn))) / 2.0 / (ga_info->bias-1);
 }
 
 /*----------------------------------------------------------------------------
-| Roulette helper (minimizing)
+| Stochastic universal sampling (Baker)
+|
+| The wheel of the roulette with as many evenly spaced pointers as there
+| are chromosomes to pick, spun once: each chromosome is picked within one
+| of its expected number of times.  That takes a batch (see SE_batch()),
+| so a single pick, as in a steady state GA, is a roulette spin.
 ----------------------------------------------------------------------------*/
-SE_min_roulette(ga_info, pool)
+SE_sus(ga_info, pool)
    GA_Info_Ptr ga_info;
    Pool_Ptr    pool;
 {
-   int   i = 0;
-   float val = 0.0, spin_val;
-
    /*--- Error check ---*/
-   if(!CF_valid(ga_info)) UT_error("SE_min_roulette: invalid ga_info");
-
-   /*--- Spin the wheel (value between 0.0 and 100.0) ---*/
-   spin_val = RAND_FRAC() * 100.0;
+   if(!CF_valid(ga_info)) UT_error("SE_sus: invalid ga_info");
 
-   /*--- Find corresponding chromosome ---*/
-   while(val < spin_val && i < pool->size)
-      val += pool->chrom[i++]->ptf;
-   if(i > 0) i--;
+   /*--- Find PTF for each chromosome ---*/
+   if(!ga_info->se_ready) PL_update_ptf(ga_info, pool);
 
-   return i;
+   return SE_spin(ga_info, pool);
 }
 
 /*----------------------------------------------------------------------------
-| Rank biased 
+| Sus helper: num chromosomes of a prepared pool (see PL_update_ptf()) into
+| chrom[], with a single spin of the wheel
+|
+| The slices are added up in double in slot order, so the picks come out in
+| slot order too; they are shuffled so that parents are paired at random.
 ----------------------------------------------------------------------------*/
-SE_rank_biased(ga_info, pool)
+static SE_sus_batch(ga_info, pool, chrom, num)
    GA_Info_Ptr ga_info;
    Pool_Ptr    pool;
+   Chrom_Ptr   *chrom;
+   int         num;
 {
-   static int ranked = FALSE;
+   Chrom_Ptr tmp;
+   double    width, total, step, start, sum;
+   int       i, j, k, last;
 
-   /*--- Error check ---*/
-   if(!CF_valid(ga_info)) UT_error("SE_rank_biased: invalid ga_info");
+   /*--- Width of the wheel, and the last slice that is there ---*/
+   for(i = 0, total = 0.0, last = -1; i < pool->size; i++) {
+      width = PL_SLICE(ga_info, pool, i);
+      if(width > 0.0) {
+         total += width;
+         last = i;
+      }
+   }
 
-   /*--- Rank pool ---*/
-   if(!ranked) {
-      PL_sort(ga_info, pool);
+   /*--- No widths to go by: every slice alike ---*/
+   if(!(total > 0.0) || total > DBL_MAX) last = -1;
+   if(last < 0) total = pool->size;
 
-      /*--- Only rank once if replacement is by_rank ---*/
-      if(!strcmp(RE_name(ga_info), "by_rank")) ranked = TRUE;
+   /*--- One spin places all the pointers ---*/
+   step  = total / num;
+   start = RN_frac(&ga_info->rn);
+   for(k = 0, i = 0, sum = 0.0; k < num; k++) {
+      for( ; i < pool->size; i++) {
+         width = last < 0 ? 1.0 : PL_SLICE(ga_info, pool, i);
+         if(width > 0.0 && (start + k) * step < sum + width) break;
+         if(width > 0.0) sum += width;
+      }
+      if(i >= pool->size) i = last < 0 ? pool->size - 1 : last;
+      chrom[k] = pool->chrom[i];
    }
 
-   /*--- Linear biased selection ---*/
-   return pool->size * (ga_info->bias - sqrt(ga_info->bias * ga_info->bias
-          - 4.0 * (ga_info->bias-1) * RAND_FRAC())) / 2.0 / (ga_info->bias-1);
+   /*--- Shuffle the picks ---*/
+   for(k = num - 1; k > 0; k--) {
+      j = RN_dom(&ga_info->rn, 0, k);
+      tmp      = chrom[k];
+      chrom[k] = chrom[j];
+      chrom[j] = tmp;
+   }
+
+   return OK;
 }
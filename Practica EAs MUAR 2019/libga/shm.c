@@ -0,0 +1,395 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Read-only pool monitor, in shared memory
+|
+| Functions:
+|    SM_create()  - create a named shared memory segment for a pool
+|    SM_attach()  - attach to a segment created by another process
+|    SM_free()    - detach (and remove, if we created it) a segment
+|    SM_valid()   - is a segment valid?
+|    SM_sync()    - publish the pool when it is time (GA side)
+|    SM_publish() - copy a pool into the segment
+|    SM_read()    - copy a consistent image of the pool out of the segment
+|    SM_live()    - is the GA that created the segment still running?
+|
+| Utility
+|    SM_map()     - map a segment
+|
+| NOTE: The segment is a snapshot of the pool, not the pool itself: the
+|       GA that creates it (shm_name) is its only writer, and every
+|       shm_interval iterations copies its pool (genes and fitness) and
+|       statistics into it.  Any number of other processes can map the
+|       segment and read it (e.g. ga-watch); they never lock anything and
+|       cannot change the GA's pool.  A sequence number, odd while the GA
+|       writes, tells readers to try again if the image changed under them
+|       (a seqlock).
+|
+| Layout (in the byte order of the machine):
+|
+|    header:  SM_Head_Type
+|    slots:   max_size pool slots, each one an SM_Slot_Type followed by
+|             chrom_len genes (Gene_Type)
+============================================================================*/
+#include "ga.h"
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SM_MAGIC  0x4C474153   /* "LGAS", also checks byte order */
+#define SM_TRIES  1000         /* Reads before checking the writer is alive */
+
+/*--- Header of a segment ---*/
+typedef struct {
+   int          magic;        /* SM_MAGIC, written last */
+   int          gene_size;    /* sizeof(Gene_Type) */
+   int          max_size;     /* Pool slots */
+   int          chrom_len;    /* Genes per chromosome */
+   int          slot_size;    /* Bytes per slot */
+   int          owner;        /* Process id of the GA */
+   int          done;         /* Has the GA finished? */
+   unsigned int seq;          /* Odd while the pool image is written */
+
+   /*--- Pool image (under seq) ---*/
+   int          size;         /* Chromosomes in image */
+   int          iter;         /* Iteration of image */
+   int          minimize;     /* Minimizing? */
+   int          best_index;   /* Index of best chromosome */
+   double       min, max, ave, var, dev, total_fitness;
+} SM_Head_Type, *SM_Head_Ptr;
+
+/*--- A slot (genes follow) ---*/
+typedef struct {
+   int    length;    /* Genes */
+   double fitness;   /* Fitness */
+} SM_Slot_Type, *SM_Slot_Ptr;
+
+#define SM_HEAD(sm)    ((SM_Head_Ptr)(sm)->base)
+#define SM_SLOT(sm, i) ((SM_Slot_Ptr)((sm)->base + sizeof(SM_Head_Type) + \
+                        (size_t)(i) * SM_HEAD(sm)->slot_size))
+#define SM_GENE(slot)  ((Gene_Ptr)((char *)(slot) + sizeof(SM_Slot_Type)))
+
+SM_Ptr SM_map();
+
+/*----------------------------------------------------------------------------
+| Create a segment for a pool of up to max_size chromosomes of chrom_len
+| genes (an old segment of the same name is replaced)
+----------------------------------------------------------------------------*/
+SM_Ptr SM_create(name, max_size, chrom_len)
+   char *name;
+   int  max_size, chrom_len;
+{
+   SM_Ptr      sm;
+   SM_Head_Ptr head;
+   int         slot_size;
+
+   /*--- Error check ---*/
+   if(max_size <= 0) UT_error("SM_create: invalid max_size");
+   if(chrom_len <= 0) UT_error("SM_create: invalid chrom_len");
+
+   /*--- Map it ---*/
+   slot_size = sizeof(SM_Slot_Type) + chrom_len * sizeof(Gene_Type);
+   sm = SM_map(name, TRUE, sizeof(SM_Head_Type) +
+               (size_t)max_size * slot_size);
+   if(sm == NULL) UT_error("SM_create: cannot create shared memory");
+
+   /*--- Header (the segment is all zeros: empty pool) ---*/
+   head = SM_HEAD(sm);
+   head->gene_size  = sizeof(Gene_Type);
+   head->max_size   = max_size;
+   head->chrom_len  = chrom_len;
+   head->slot_size  = slot_size;
+   head->owner      = (int)getpid();
+   head->best_index = -1;
+   __atomic_store_n(&head->magic, SM_MAGIC, __ATOMIC_RELEASE);
+
+   return sm;
+}
+
+/*----------------------------------------------------------------------------
+| Attach to the segment of a GA; NULL if there is none (yet)
+----------------------------------------------------------------------------*/
+SM_Ptr SM_attach(name)
+   char *name;
+{
+   SM_Ptr      sm;
+   SM_Head_Ptr head;
+
+   if((sm = SM_map(name, FALSE, 0)) == NULL) return NULL;
+
+   /*--- Same library, same machine, and done setting it up? ---*/
+   head = SM_HEAD(sm);
+   if(__atomic_load_n(&head->magic, __ATOMIC_ACQUIRE) != SM_MAGIC ||
+      head->gene_size != sizeof(Gene_Type) ||
+      sm->size < sizeof(SM_Head_Type) +
+                 (size_t)head->max_size * head->slot_size) {
+      SM_free(sm);
+      return NULL;
+   }
+
+   return sm;
+}
+
+/*----------------------------------------------------------------------------
+| Detach a segment; the GA that created it also removes it, telling readers
+| that it is done
+----------------------------------------------------------------------------*/
+SM_free(sm)
+   SM_Ptr sm;
+{
+   /*--- Nothing to free ---*/
+   if(sm == NULL) return OK;
+
+   /*--- Error check ---*/
+   if(!SM_valid(sm)) UT_error("SM_free: invalid sm");
+
+   /*--- Last words of the GA ---*/
+   if(sm->owner) {
+      __atomic_store_n(&SM_HEAD(sm)->done, TRUE, __ATOMIC_RELEASE);
+      shm_unlink(sm->name);
+   }
+
+   /*--- Free memory ---*/
+   munmap(sm->base, sm->size);
+   sm->magic_cookie = NL_cookie;
+   free(sm);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Is a segment valid, i.e., has it been made by SM_create() or SM_attach()?
+----------------------------------------------------------------------------*/
+SM_valid(sm)
+   SM_Ptr sm;
+{
+   /*--- Check for NULL pointers ---*/
+   if(sm == NULL) return FALSE;
+   if(sm->base == NULL) return FALSE;
+
+   /*--- Check for magic cookie ---*/
+   if(sm->magic_cookie != SM_cookie) return FALSE;
+
+   /*--- Otherwise valid ---*/
+   return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+| Publish the pool every shm_interval iterations
+----------------------------------------------------------------------------*/
+SM_sync(ga_info, pool)
+   GA_Info_Ptr ga_info;
+   Pool_Ptr    pool;
+{
+   SM_Ptr sm;
+
+   /*--- Time to do it? ---*/
+   sm = ga_info->sm;
+   if(sm == NULL || (ga_info->iter + 1) % ga_info->shm_interval != 0)
+      return OK;
+
+   return SM_publish(sm, pool, ga_info->iter);
+}
+
+/*----------------------------------------------------------------------------
+| Copy (up to max_size chromosomes of) a pool into the segment
+----------------------------------------------------------------------------*/
+SM_publish(sm, pool, iter)
+   SM_Ptr   sm;
+   Pool_Ptr pool;
+   int      iter;
+{
+   SM_Head_Ptr  head;
+   SM_Slot_Ptr  slot;
+   unsigned int seq;
+   int          i, size;
+
+   /*--- Error check ---*/
+   if(!SM_valid(sm)) UT_error("SM_publish: invalid sm");
+   if(!PL_valid(pool)) UT_error("SM_publish: invalid pool");
+   head = SM_HEAD(sm);
+   size = MIN(pool->size, head->max_size);
+
+   /*--- Readers: hands off ---*/
+   seq = head->seq;
+   __atomic_store_n(&head->seq, seq + 1, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+
+   /*--- Chromosomes ---*/
+   for(i = 0; i < size; i++) {
+      slot = SM_SLOT(sm, i);
+      slot->length  = MIN(pool->chrom[i]->length, head->chrom_len);
+      slot->fitness = pool->fit[i];
+      memcpy((char *)SM_GENE(slot), (char *)pool->chrom[i]->gene,
+             slot->length * sizeof(Gene_Type));
+   }
+
+   /*--- Statistics ---*/
+   head->size          = size;
+   head->iter          = iter;
+   head->minimize      = pool->minimize;
+   head->best_index    = (pool->best_index < size) ? pool->best_index : -1;
+   head->min           = pool->min;
+   head->max           = pool->max;
+   head->ave           = pool->ave;
+   head->var           = pool->var;
+   head->dev           = pool->dev;
+   head->total_fitness = pool->total_fitness;
+
+   /*--- Readers: go ahead ---*/
+   __atomic_store_n(&head->seq, seq + 2, __ATOMIC_RELEASE);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Copy a consistent image of the pool into pool (chromosomes allocated as
+| needed); returns its iteration, ERROR if the GA died while writing it
+----------------------------------------------------------------------------*/
+SM_read(sm, pool)
+   SM_Ptr   sm;
+   Pool_Ptr pool;
+{
+   SM_Head_Ptr  head;
+   SM_Slot_Ptr  slot;
+   unsigned int seq;
+   int          i, size, len, iter, tries;
+
+   /*--- Error check ---*/
+   if(!SM_valid(sm)) UT_error("SM_read: invalid sm");
+   if(!PL_valid(pool)) UT_error("SM_read: invalid pool");
+   head = SM_HEAD(sm);
+
+   /*--- Room for all of them ---*/
+   if(pool->max_size < head->max_size) PL_resize(pool, head->max_size);
+   for(i = 0; i < head->max_size; i++) {
+      if(CH_valid(pool->chrom[i]) && pool->chrom[i]->length != head->chrom_len)
+         CH_resize(pool->chrom[i], head->chrom_len);
+      if(!CH_valid(pool->chrom[i]))
+         pool->chrom[i] = CH_alloc(head->chrom_len);
+   }
+
+   /*--- Copy until nobody wrote while we were at it ---*/
+   for(tries = 1; ; tries++) {
+      seq = __atomic_load_n(&head->seq, __ATOMIC_ACQUIRE);
+      if((seq & 1) == 0) {
+         size = MIN(head->size, head->max_size);
+         for(i = 0; i < size; i++) {
+            slot = SM_SLOT(sm, i);
+            len  = MIN(MAX(slot->length, 0), head->chrom_len);
+            pool->chrom[i]->fitness = slot->fitness;
+            memcpy((char *)pool->chrom[i]->gene, (char *)SM_GENE(slot),
+                   len * sizeof(Gene_Type));
+            PL_FIT(pool, i);
+         }
+         pool->size          = size;
+         pool->minimize      = head->minimize;
+         pool->best_index    = head->best_index;
+         pool->min           = head->min;
+         pool->max           = head->max;
+         pool->ave           = head->ave;
+         pool->var           = head->var;
+         pool->dev           = head->dev;
+         pool->total_fitness = head->total_fitness;
+         iter                = head->iter;
+         __atomic_thread_fence(__ATOMIC_ACQUIRE);
+         if(__atomic_load_n(&head->seq, __ATOMIC_RELAXED) == seq) break;
+      }
+
+      /*--- Writer still there? ---*/
+      if(tries % SM_TRIES == 0 && !SM_live(sm)) return ERROR;
+      sched_yield();
+   }
+
+   /*--- Indexes are those of the GA's pool ---*/
+   pool->min_index = pool->max_index = -1;
+   pool->sorted    = FALSE;
+
+   return iter;
+}
+
+/*----------------------------------------------------------------------------
+| Is the GA that created the segment still running?
+----------------------------------------------------------------------------*/
+SM_live(sm)
+   SM_Ptr sm;
+{
+   SM_Head_Ptr head;
+
+   /*--- Error check ---*/
+   if(!SM_valid(sm)) UT_error("SM_live: invalid sm");
+   head = SM_HEAD(sm);
+
+   if(__atomic_load_n(&head->done, __ATOMIC_ACQUIRE)) return FALSE;
+   if(kill((pid_t)head->owner, 0) < 0 && errno == ESRCH) return FALSE;
+
+   return TRUE;
+}
+
+/*============================================================================
+|                                  Utility
+============================================================================*/
+/*----------------------------------------------------------------------------
+| Map segment name ("/name"; the '/' is added if missing), creating it with
+| size bytes if create; NULL if it cannot be done
+----------------------------------------------------------------------------*/
+SM_Ptr SM_map(name, create, size)
+   char   *name;
+   int    create;
+   size_t size;
+{
+   SM_Ptr      sm;
+   struct stat st;
+   int         fd;
+
+   /*--- Error check ---*/
+   if(name == NULL || name[0] == '\0' || strlen(name) > 78)
+      UT_error("SM_map: invalid name");
+
+   sm = (SM_Ptr)calloc(1, sizeof(SM_Type));
+   if(sm == NULL) UT_error("SM_map: alloc failed");
+   sprintf(sm->name, "%s%s", name[0] == '/' ? "" : "/", name);
+   sm->owner = create;
+
+   /*--- Open it (a new one is all zeros) ---*/
+   if(create) {
+      shm_unlink(sm->name);
+      fd = shm_open(sm->name, O_RDWR | O_CREAT | O_EXCL, 0600);
+      if(fd >= 0 && ftruncate(fd, (off_t)size) < 0) {
+         close(fd);
+         fd = -1;
+      }
+   } else {
+      fd = shm_open(sm->name, O_RDWR, 0);
+      if(fd >= 0 && (fstat(fd, &st) < 0 || st.st_size < sizeof(SM_Head_Type))) {
+         close(fd);
+         fd = -1;
+      }
+      size = (fd >= 0) ? (size_t)st.st_size : 0;
+   }
+   if(fd < 0) {
+      free(sm);
+      return NULL;
+   }
+
+   /*--- Map it ---*/
+   sm->size = size;
+   sm->base = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           fd, 0);
+   close(fd);
+   if(sm->base == (char *)MAP_FAILED) {
+      if(create) shm_unlink(sm->name);
+      free(sm);
+      return NULL;
+   }
+
+   /*--- Put in magic cookie ---*/
+   sm->magic_cookie = SM_cookie;
+
+   return sm;
+}
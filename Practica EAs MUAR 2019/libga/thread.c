@@ -0,0 +1,215 @@
+/*============================================================================
+| (c) Copyright Arthur L. Corcoran, 1992, 1993.  All rights reserved.
+|
+| Thread pool
+|
+| Functions:
+|    TH_alloc()    - allocate a thread pool
+|    TH_free()     - deallocate a thread pool
+|    TH_valid()    - is a thread pool valid?
+|    TH_run()      - apply a function to items 0..num-1 in parallel
+|    TH_worker()   - body of each worker thread
+|    TH_do_items() - grab and process items until there are none left
+|
+| NOTE: The calling thread takes part in TH_run(), so a pool of N threads
+|       only starts N-1 workers.  Each call to the item function gets the
+|       id of the thread running it (0 is the caller, 1..N-1 the workers).
+============================================================================*/
+#include "ga.h"
+
+void *TH_worker();
+
+/*----------------------------------------------------------------------------
+| Allocate a thread pool
+----------------------------------------------------------------------------*/
+TH_Pool_Ptr TH_alloc(num_threads)
+   int num_threads;
+{
+   TH_Pool_Ptr tp;
+   int         i;
+
+   /*--- Error check ---*/
+   if(num_threads <= 0) UT_error("TH_alloc: invalid num_threads");
+
+   /*--- Allocate memory for thread pool ---*/
+   tp = (TH_Pool_Ptr)calloc(1, sizeof(TH_Pool_Type));
+   if(tp == NULL) UT_error("TH_alloc: pool alloc failed");
+   tp->num_threads = num_threads;
+
+   /*--- Allocate memory for thread ids ---*/
+   tp->tid = (pthread_t *)calloc(num_threads, sizeof(pthread_t));
+   if(tp->tid == NULL) UT_error("TH_alloc: tid alloc failed");
+
+   /*--- Synchronization ---*/
+   pthread_mutex_init(&tp->lock, NULL);
+   pthread_cond_init(&tp->work_cv, NULL);
+   pthread_cond_init(&tp->done_cv, NULL);
+   tp->job_id      = 0;
+   tp->num_started = 0;
+   tp->quit        = FALSE;
+
+   /*--- Put in magic cookie ---*/
+   tp->magic_cookie = TH_cookie;
+
+   /*--- Start the workers (thread 0 is the caller) ---*/
+   for(i = 1; i < num_threads; i++)
+      if(pthread_create(&tp->tid[i], NULL, TH_worker, (void *)tp) != 0)
+         UT_error("TH_alloc: pthread_create failed");
+
+   return tp;
+}
+
+/*----------------------------------------------------------------------------
+| De-Allocate a thread pool
+----------------------------------------------------------------------------*/
+void TH_free(tp)
+   TH_Pool_Ptr tp;
+{
+   int i;
+
+   /*--- Error check ---*/
+   if(!TH_valid(tp)) return;
+
+   /*--- Tell workers to quit ---*/
+   pthread_mutex_lock(&tp->lock);
+   tp->quit = TRUE;
+   pthread_cond_broadcast(&tp->work_cv);
+   pthread_mutex_unlock(&tp->lock);
+
+   /*--- Wait for them ---*/
+   for(i = 1; i < tp->num_threads; i++)
+      pthread_join(tp->tid[i], NULL);
+
+   /*--- Release resources ---*/
+   pthread_mutex_destroy(&tp->lock);
+   pthread_cond_destroy(&tp->work_cv);
+   pthread_cond_destroy(&tp->done_cv);
+   free(tp->tid);
+
+   /*--- Put in a NULL magic cookie ---*/
+   tp->magic_cookie = NL_cookie;
+
+   free(tp);
+}
+
+/*----------------------------------------------------------------------------
+| Is thread pool valid, i.e., has it been allocated by TH_alloc()?
+----------------------------------------------------------------------------*/
+TH_valid(tp)
+   TH_Pool_Ptr tp;
+{
+   /*--- Check for NULL pointers ---*/
+   if(tp == NULL) return FALSE;
+
+   /*--- Check for magic cookie ---*/
+   if(tp->magic_cookie != TH_cookie) return FALSE;
+
+   /*--- Otherwise valid ---*/
+   return TRUE;
+}
+
+/*----------------------------------------------------------------------------
+| Call fun(arg, i, id) for i = 0..num-1 using every thread in the pool
+|
+| Returns once all items are done.  Items are handed out in chunks, so
+| the order in which they are processed is NOT defined.
+----------------------------------------------------------------------------*/
+TH_run(tp, fun, arg, num)
+   TH_Pool_Ptr tp;
+   void        (*fun)();
+   void        *arg;
+   int         num;
+{
+   /*--- Error check ---*/
+   if(!TH_valid(tp)) UT_error("TH_run: invalid thread pool");
+   if(fun == NULL) UT_error("TH_run: null fun");
+   if(num <= 0) return OK;
+
+   /*--- Post the job ---*/
+   pthread_mutex_lock(&tp->lock);
+   tp->fun       = fun;
+   tp->arg       = arg;
+   tp->num_items = num;
+   tp->next_item = 0;
+   tp->chunk     = MAX(1, num / (4 * tp->num_threads));
+   tp->num_busy  = tp->num_threads - 1;
+   tp->job_id++;
+   pthread_cond_broadcast(&tp->work_cv);
+   pthread_mutex_unlock(&tp->lock);
+
+   /*--- Caller does its share ---*/
+   TH_do_items(tp, 0);
+
+   /*--- Wait for the workers to finish ---*/
+   pthread_mutex_lock(&tp->lock);
+   while(tp->num_busy > 0)
+      pthread_cond_wait(&tp->done_cv, &tp->lock);
+   pthread_mutex_unlock(&tp->lock);
+
+   return OK;
+}
+
+/*----------------------------------------------------------------------------
+| Worker thread
+----------------------------------------------------------------------------*/
+void *TH_worker(arg)
+   void *arg;
+{
+   TH_Pool_Ptr tp;
+   int         id, job_id;
+
+   tp = (TH_Pool_Ptr)arg;
+
+   /*--- Take the next id (jobs posted before we got here are not lost) ---*/
+   pthread_mutex_lock(&tp->lock);
+   id     = ++tp->num_started;
+   job_id = 0;
+
+   while(TRUE) {
+
+      /*--- Wait for a new job ---*/
+      while(!tp->quit && tp->job_id == job_id)
+         pthread_cond_wait(&tp->work_cv, &tp->lock);
+      if(tp->quit) break;
+      job_id = tp->job_id;
+      pthread_mutex_unlock(&tp->lock);
+
+      /*--- Do my share ---*/
+      TH_do_items(tp, id);
+
+      /*--- Report back ---*/
+      pthread_mutex_lock(&tp->lock);
+      if(--tp->num_busy == 0)
+         pthread_cond_signal(&tp->done_cv);
+   }
+   pthread_mutex_unlock(&tp->lock);
+
+   return NULL;
+}
+
+/*----------------------------------------------------------------------------
+| Process chunks of items until all have been handed out
+----------------------------------------------------------------------------*/
+TH_do_items(tp, id)
+   TH_Pool_Ptr tp;
+   int         id;
+{
+   int i, first, last;
+
+   while(TRUE) {
+
+      /*--- Grab a chunk ---*/
+      pthread_mutex_lock(&tp->lock);
+      first = tp->next_item;
+      tp->next_item += tp->chunk;
+      pthread_mutex_unlock(&tp->lock);
+
+      /*--- Nothing left ---*/
+      if(first >= tp->num_items) break;
+      last = MIN(first + tp->chunk, tp->num_items);
+
+      /*--- Process it ---*/
+      for(i = first; i < last; i++)
+         tp->fun(tp->arg, i, id);
+   }
+}